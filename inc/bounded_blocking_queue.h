@@ -3,18 +3,35 @@
 
 #include<buffer_pool_man_types.h>
 
+/*
+	bbqueue is a bounded multi producer multi consumer queue of page ids
+	pushes and pops are lock free (a ring of slots, each with its own sequence number)
+	a thread only spins for a while and then sleeps (on a futex), when it has to wait for the queue to not be full (push) or not be empty (pop)
+*/
+
 typedef struct bbqueue bbqueue;
 
-bbqueue* get_bbqueue(uint16_t size);
+bbqueue* get_bbqueue(uint32_t size);
 
+// these two functions only give a snapshot, the queue may change as soon as they return
 int is_bbqueue_empty(bbqueue* bbq);
 
 int is_bbqueue_full(bbqueue* bbq);
 
+// blocks while the queue is full
 void push_bbqueue(bbqueue* bbq, PAGE_ID page_id);
 
+// blocks while the queue is empty
 PAGE_ID pop_bbqueue(bbqueue* bbq);
 
+// pushes all the page_ids_count page ids, in order, blocking whenever the queue is full
+// the consumers are woken up once for the whole batch (unless this function has to wait for them to make space)
+void push_bbqueue_batch(bbqueue* bbq, const PAGE_ID* page_ids, uint32_t page_ids_count);
+
+// blocks while the queue is empty, and then pops all (but atmost max_page_ids_count) the page ids that are in the queue
+// it returns the number of page ids popped, which is always atleast 1 (for max_page_ids_count > 0)
+uint32_t pop_bbqueue_batch(bbqueue* bbq, PAGE_ID* page_ids, uint32_t max_page_ids_count);
+
 void delete_bbqueue(bbqueue* bbq);
 
 #endif
\ No newline at end of file
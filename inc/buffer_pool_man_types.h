@@ -14,6 +14,9 @@ typedef uint32_t	BLOCK_COUNT;
 typedef uint64_t 	TIMESTAMP_ms;
 typedef uint64_t 	TIME_ms;
 
+typedef uint64_t 	TIMESTAMP_ns;
+typedef uint64_t 	TIME_ns;
+
 typedef uint32_t 	SIZE_IN_BYTES;
 
 #include<errno.h>
@@ -21,8 +24,12 @@ typedef uint32_t 	SIZE_IN_BYTES;
 #include<sys/time.h>
 
 #define setToCurrentUnixTimestamp(var) 		{struct timeval tp;gettimeofday(&tp,NULL);var = tp.tv_sec * 1000 + tp.tv_usec / 1000;}
+#define setToCurrentMonotonicTimestamp_ns(var)	{struct timespec tp;clock_gettime(CLOCK_MONOTONIC, &tp);var = ((TIMESTAMP_ns)tp.tv_sec) * 1000000000ULL + tp.tv_nsec;}
 #define sleepForMilliseconds(var)			{struct timespec tp;tp.tv_sec = var/1000;tp.tv_nsec = (var%1000) * 1000000;if(nanosleep(&tp, NULL) == -1){printf("nano sleep failed with %d\n", errno);}}
 
+// the structures written by many threads are aligned (and padded) to this, so that the unrelated writes do not fall on the same cache line
+#define CACHE_LINE_SIZE 64
+
 #define compare_unsigned(a, b)	((a>b)?1:((a<b)?(-1):0))
 
 #endif
\ No newline at end of file
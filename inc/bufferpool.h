@@ -5,32 +5,92 @@
 
 #include<bounded_blocking_queue.h>
 
+#include<latency_histogram.h>
+
 typedef struct bufferpool bufferpool;
 
 // creates a new buffer pool manager, that will maintain a heap file given by the name heap_file_name
-bufferpool* get_bufferpool(char* heap_file_name, PAGE_COUNT pages_in_cache, SIZE_IN_BYTES page_size_in_bytes, uint8_t io_thread_count, TIME_ms cleanup_rate_in_milliseconds, TIME_ms unused_prefetched_page_return_in_ms);
+// read_io_thread_count threads read the requested pages from disk (writing the dirty pages they replace), while
+// write_io_thread_count threads write the dirty pages queued for clean up, so that the page reads never wait behind a burst of clean up writes
+bufferpool* get_bufferpool(char* heap_file_name, PAGE_COUNT pages_in_cache, SIZE_IN_BYTES page_size_in_bytes, uint8_t read_io_thread_count, uint8_t write_io_thread_count, TIME_ms cleanup_rate_in_milliseconds, TIME_ms unused_prefetched_page_return_in_ms);
+
+// the kind of latch (lock) held on the page, through a page_handle
+typedef enum page_latch_mode page_latch_mode;
+enum page_latch_mode
+{
+	NO_LATCH = 0,
+	READER_LATCH,
+	WRITER_LATCH,
+};
+
+// a page_handle is returned to you, when you acquire a page,
+// it must be provided back to the bufferpool to downgrade, mark dirty or release the page
+// do not modify any of its attributes, they are managed by the bufferpool
+typedef struct page_handle page_handle;
+struct page_handle
+{
+	// pointer to the in-memory copy of the page, that you may read/write as per your latch_mode
+	void* page_memory;
+
+	// the page_id of the page that is held by this handle
+	PAGE_ID page_id;
+
+	// the index of the frame (page_entry) of the bufferpool that holds the page
+	PAGE_COUNT frame_index;
+
+	// the latch that is held on the page, it is NO_LATCH once the page has been released
+	page_latch_mode latch_mode;
+};
 
 // locks the page for reading
 // multiple threads can read the same page simultaneously,
 // but no other write thread will be allowed
-void* acquire_page_with_reader_lock(bufferpool* buffp, PAGE_ID page_id);
+page_handle acquire_page_with_reader_lock(bufferpool* buffp, PAGE_ID page_id);
 
 // lock the page for writing
 // multiple threads will not be allowed to write the same page simultaneously
 // this function will give you exclusive access to the page
-void* acquire_page_with_writer_lock(bufferpool* buffp, PAGE_ID page_id);
+page_handle acquire_page_with_writer_lock(bufferpool* buffp, PAGE_ID page_id);
 
-// upgrade an already writer lock on the page to a reader lock 
+// downgrade an already writer lock on the page to a reader lock 
 // returns 1, if the operation succeeded, else it returns 0
-int downgrade_page_lock_from_writer_to_reader(bufferpool* buffp, void* page_memory);
+int downgrade_page_lock_from_writer_to_reader(bufferpool* buffp, page_handle* pg_handle);
 
-// this will unlock the page, provide the page_memory for the specific page
-// call this functions only  on the address returned after calling any one of acquire_page_with_*_lock functions respectively
+// mark the page held by the page_handle as dirty, so that it will be written to disk by the bufferpool
+// pages released from a writer lock are marked dirty anyway, use this only if you need it prior to release
+// the page_handle must be holding a writer lock on the page (latch_mode == WRITER_LATCH), a page held with a reader lock can not be marked dirty
+// returns 1, if the operation succeeded, else it returns 0 (also if the page_handle is not holding a writer lock)
+int mark_page_as_dirty(bufferpool* buffp, page_handle* pg_handle);
+
+// this will unlock the page, provide the page_handle returned by any one of acquire_page_with_*_lock functions
 // the release page method can be called, to release a page read/write lock,
 // if okay_to_evict is set, the page_entry is evicted if it is not being used by anyone else
 // this can be used to allow evictions while performing a sequential scan
+// once released, the latch_mode of the page_handle is set to NO_LATCH and it must not be used to access the page
+// it returns 0, if the lock could not be released
+int release_page_lock(bufferpool* buffp, page_handle* pg_handle, int okay_to_evict);
+
+// a scan_ring is a small bounded set of frames of the bufferpool, private to a sequential scan
+// the pages missed by the scan are read into these frames in a round robin manner, instead of evicting the pages of the rest of the bufferpool
+// a full table scan using a scan_ring, leaves the working set of the rest of the bufferpool untouched
+typedef struct scan_ring scan_ring;
+
+// creates a scan_ring of atmost ring_size frames, the ring_size is limited to a quarter of the pages in the bufferpool
+// a scan_ring must be used by one scan at a time
+scan_ring* get_scan_ring(bufferpool* buffp, PAGE_COUNT ring_size);
+
+// same as acquire_page_with_reader_lock and acquire_page_with_writer_lock,
+// except that if the page is not in memory, it will be read into a frame of the scan_ring
+page_handle acquire_page_with_reader_lock_for_scan(bufferpool* buffp, scan_ring* ring, PAGE_ID page_id);
+page_handle acquire_page_with_writer_lock_for_scan(bufferpool* buffp, scan_ring* ring, PAGE_ID page_id);
+
+// release the page, acquired using the acquire_page_with_*_lock_for_scan functions, using the same scan_ring
 // it returns 0, if the lock could not be released
-int release_page_lock(bufferpool* buffp, void* page_memory, int okay_to_evict);
+int release_page_lock_for_scan(bufferpool* buffp, scan_ring* ring, page_handle* pg_handle);
+
+// returns all the frames of the scan_ring back to the bufferpool and deletes the scan_ring
+// all the pages acquired using this scan_ring must be released before calling this function
+void delete_scan_ring(bufferpool* buffp, scan_ring* ring);
 
 // to request a page_prefetch, you must provide a start_page_id, and page_count
 // this will help us fetch adjacent pages to memory faster by using sequential io
@@ -38,7 +98,42 @@ int release_page_lock(bufferpool* buffp, void* page_memory, int okay_to_evict);
 // whenever a page is available in memory, the page_id of that page will be made available to you, as we push the page_id in the bbq
 // if the bbq is already full, the bufferpool will go into wait state, taking all important lock with it, this is not at all good,
 // SO PLEASE PLEASE PLEASE, keep the size of bounded_blocking_queue more than enough, to accomodate the number of pages, at any instant
-void request_page_prefetch(bufferpool* buffp, PAGE_ID start_page_id, PAGE_COUNT page_count, bbqueue* bbq);
+// the prefetch requests are fulfilled only after all the pending page requests of the threads that are waiting to acquire locks on pages
+// it returns a prefetch_handle, that can be used to cancel the prefetch, if you do not need the pages anymore
+typedef struct prefetch_handle prefetch_handle;
+struct prefetch_handle
+{
+	PAGE_ID start_page_id;
+
+	PAGE_COUNT page_count;
+
+	bbqueue* bbq;
+};
+prefetch_handle request_page_prefetch(bufferpool* buffp, PAGE_ID start_page_id, PAGE_COUNT page_count, bbqueue* bbq);
+
+// cancels the pages of the prefetch, whose page_ids have not yet been pushed to the bbq, the bbq will not receive their page_ids
+// the disk io of a cancelled page is avoided, if its io has not yet been dispatched and if no one else has requested for it
+// it returns the number of pages cancelled, the page_ids of the rest of the pages of the prefetch are (or will be) pushed to the bbq
+PAGE_COUNT cancel_page_prefetch(bufferpool* buffp, prefetch_handle* pf_handle);
+
+// a shared_scan lets concurrent sequential scans over the same range of pages share their disk io
+// a new shared_scan attaches to the running shared_scans (over the same range) at their current position, consuming the pages they load,
+// and then it wraps around to receive the pages that it missed
+typedef struct shared_scan shared_scan;
+
+// joins (or starts) a shared scan over the pages from start_page_id to (start_page_id + page_count - 1)
+// window_size is the maximum number of pages that may be brought to memory for this scan, but not yet consumed
+// the bufferpool must have enough pages to hold the windows of all the concurrent shared_scans
+shared_scan* join_shared_scan(bufferpool* buffp, PAGE_ID start_page_id, PAGE_COUNT page_count, PAGE_COUNT window_size);
+
+// blocks untill the next page of the range (that the scan has not yet received) is brought to memory and sets it in *page_id
+// the pages are not returned in the order of page_id, but in the order in which they are brought to memory
+// you must then acquire the page (using its page_id) to access it
+// it returns 0, once all the pages of the range have been returned to this scan
+int get_next_page_of_shared_scan(bufferpool* buffp, shared_scan* sscan, PAGE_ID* page_id);
+
+// leaves the shared scan, whether or not all of its pages were consumed, and deletes the shared_scan
+void leave_shared_scan(bufferpool* buffp, shared_scan* sscan);
 
 // this function is blocking and it will return only when the page write to disk succeeds
 // or if the page is already queued for cleanup by some other user thread
@@ -46,6 +141,197 @@ void request_page_prefetch(bufferpool* buffp, PAGE_ID start_page_id, PAGE_COUNT
 // you may call this function while holding a read lock on the given page
 void force_write(bufferpool* buffp, PAGE_ID page_id);
 
+// preallocates the disk space for the pages (using fallocate), ahead of their first writes, so that the heap file is not extended by the writes past its end
+// the allocation is rounded up to chunks of DISK_RESERVATION_CHUNK_SIZE (8 MB), so the heap file grows in large extents, the pages below the last reservation are not reserved again
+// (this includes the pages freed by free_pages_on_disk, they get their disk space back only when they are written)
+// the reserved pages read as zeros, until they are written, it returns 0, if the file system can not preallocate
+int reserve_pages_on_disk(bufferpool* buffp, PAGE_ID start_page_id, PAGE_COUNT page_count);
+
+// frees the disk space of the pages (by punching a hole), the pages read as zeros from then on, and the heap file keeps its size
+// the pages are dropped from the bufferpool (and its second tiers) without being written, the pages must not be in use
+// it returns 0 without freeing anything, if any of the pages is pinned (held with a lock by some thread),
+// and it returns 0, if the file system can not punch holes, the pages are dropped even then
+int free_pages_on_disk(bufferpool* buffp, PAGE_ID start_page_id, PAGE_COUNT page_count);
+
+// by default, the outstanding page requests (of the same class) are read from disk strictly in the order of their priority (their age)
+// with a non zero priority_band, the page requests within priority_band of the highest priority one are read in the order of their page_ids,
+// sweeping up the disk and then wrapping around (C-SCAN elevator), this cuts the seeks of a HDD (or a RAID of HDDs) with many outstanding misses
+// the page requests older than the band are still read first, a larger band gives fewer seeks but a longer wait for the unlucky page requests
+// a priority_band of 0, disables the elevator ordering
+void set_elevator_dispatch(bufferpool* buffp, uint8_t priority_band);
+
+// sets the maximum number of pages read ahead at once, for a sequential stream of page misses (see read_ahead_detector.h)
+// the default is MAX_READ_AHEAD_WINDOW (64) pages, a max_window of 0 disables the read ahead, and it is always capped to a quarter of the bufferpool
+// the pages past the end of the heap file, and its holes (if set_hole_detection is enabled), are never read ahead
+// it must be called right after get_bufferpool, before the bufferpool is used
+void set_read_ahead_window(bufferpool* buffp, PAGE_COUNT max_window);
+
+// by default, a dirty page is written to disk while the page is read locked, so a writer of that page waits for the disk write to complete
+// with shadow copy writeback enabled, the page is copied to a staging buffer of the writing io thread and the copy is written to disk,
+// so the writers wait only for the copy, a page that is being written can not be replaced until its write completes
+void set_shadow_copy_writeback(bufferpool* buffp, int enable);
+
+// with page checksums enabled, the last PAGE_CHECKSUM_FOOTER_SIZE (8) bytes of every page are reserved for a CRC32C footer (see page_checksum.h),
+// that is stamped when the page is written to disk, and verified when it is read back, the users must never write to these bytes
+// a page that fails its verification is still handed out, but it is counted in checksum_failures of the bufferpool_stats and reported on stdout
+// it must be enabled right after get_bufferpool, and it must be enabled for every bufferpool over the file, since the file was created,
+// because the pages written without checksums (except for the pages of all zeros) fail the verification
+void set_page_checksums(bufferpool* buffp, int enable);
+
+// enables transparent LZ4 compression of the pages on disk, the pages in the bufferpool are never compressed (see page_compression.h)
+// a page that compresses by atleast a disk block is written (and later read) in fewer blocks, at the start of its slot in the heap file,
+// so the bandwidth of the disk multiplies for the compressible cold data, but the heap file is not made smaller
+// extent_map_file_name is a side file that remembers the number of blocks to read for each page, if it is lost, the pages are still read correctly (with larger reads)
+// it must be called right after get_bufferpool, and once enabled, it must be enabled for every bufferpool over the heap file, it returns 0 if the extent map file could not be opened
+int set_page_compression(bufferpool* buffp, char* extent_map_file_name);
+
+// enables the detection of the holes of the (sparse) heap file, the pages that were never written, using SEEK_DATA and SEEK_HOLE (see page_hole_map.h)
+// a page miss on a hole is served by zero filling the frame, without any disk io, this speeds up the bulk loads (appends) and the reads of sparse tables
+// no one else must write to the heap file, while the bufferpool is using it
+// it must be called right after get_bufferpool, it returns 0, if the file system of the heap file can not report its holes
+int set_hole_detection(bufferpool* buffp);
+
+// the clean pages evicted from the bufferpool can be kept LZ4 compressed in memory, in a second tier of upto bytes_budget bytes (see compressed_page_cache.h),
+// a page miss on such a page is then served by decompressing it (a few microseconds), instead of reading it from disk
+// this helps, when the working set is a little larger than the bufferpool and compresses well, a bytes_budget of 0 (the default) disables it
+// it can be changed at any time, a smaller budget evicts the oldest compressed pages right away
+void set_compressed_page_cache_budget(bufferpool* buffp, uint64_t bytes_budget);
+
+// interleaves the frames of the bufferpool, page by page, across all the NUMA nodes of the machine (see numa_placement.h), migrating them from the node of the thread that called get_bufferpool
+// so the page hits of the threads on every node see the same average memory latency, instead of all the frames being remote to all but one node
+// it is best called right after get_bufferpool, it returns 0 (and does nothing) on a machine with a single NUMA node, or if the frames could not be interleaved
+int set_numa_interleave(bufferpool* buffp);
+
+// configures a victim cache of l2_pages pages in a second file l2_file_name (see l2_page_cache.h), it must be on a faster device than the heap file (like an SSD),
+// the clean pages evicted from the bufferpool are copied there asynchronously (by the write io threads), and the page misses read them from there, if they are found
+// the l2 file is created if it does not exist, and it is sized to l2_pages pages, its contents are not reused, every bufferpool starts with an empty l2_page_cache
+// it must be called right after get_bufferpool, it returns 0, if the l2 file could not be opened or if its block size does not divide the page_size
+int set_l2_page_cache(bufferpool* buffp, char* l2_file_name, PAGE_COUNT l2_pages);
+
+// warm restart
+// the page_ids of the pages in the bufferpool (with their usage and recency, not their contents) can be dumped to a file,
+// so that a new bufferpool (of the same page_size) can be warmed up with them, instead of starting empty after a restart
+
+// writes the page_ids of the resident pages to the dump file, you may call it periodically, returns 0 on failure
+int dump_resident_pages(bufferpool* buffp, char* dump_file_name);
+
+// makes delete_bufferpool dump the resident pages to the dump file, pass NULL to not dump them
+void dump_resident_pages_on_delete(bufferpool* buffp, char* dump_file_name);
+
+// reads the pages of the dump in to the free frames of the bufferpool, in the order of their page_ids with large sequential reads,
+// and restores their recency in the lru, it returns the number of pages brought to memory
+// it must be called right after get_bufferpool, before any other thread uses the bufferpool
+PAGE_COUNT warm_up_bufferpool(bufferpool* buffp, char* dump_file_name);
+
+// limits the dirty pages in the bufferpool to dirty_percentage % of its pages (0 or 100 removes the limit, which is the default)
+// above half the limit, the writers start queuing the dirty pages for clean up (irrespective of the cleanup rate)
+// above three quarters of the limit, the writers are paused for upto 10 ms, longer the closer the dirty pages get to the limit,
+// and at the limit, they wait for the dirty pages to be written, so that the page misses rarely have to write a dirty victim
+// the writers are paused inside acquire_page_with_writer_lock (and the other calls that acquire a writer lock), while the caller may be holding locks on other pages,
+// so the limit is soft, a writer at the limit waits for atmost 40 ms (4 pauses), and then it proceeds even if the dirty pages are still at (or over) the limit
+void set_dirty_pages_ratio_limit(bufferpool* buffp, uint8_t dirty_percentage);
+
+// the counters of the bufferpool, they only grow from the creation of the bufferpool
+// all the counters must be uint64_t (they are summed up counter by counter, over the per thread shards)
+typedef struct bufferpool_stats bufferpool_stats;
+struct bufferpool_stats
+{
+	// page accesses (acquire_page_* calls) that found the page in memory
+	uint64_t page_hits;
+
+	// page accesses that had to wait for the page to be read from disk
+	uint64_t page_misses;
+
+	// page_requests created, i.e. pages that had to be read from disk
+	uint64_t page_requests_created;
+
+	// requests for a page, that piggy-backed on an existing page_request for the same page, instead of creating a new one
+	uint64_t page_requests_piggybacked;
+
+	// pages read from the disk by the io_dispatcher
+	uint64_t pages_read;
+
+	// frames that held a valid page, that were replaced to hold some other page
+	uint64_t evictions;
+
+	// dirty victim pages written to disk, by the io_dispatcher before the frame could be reused (this write is on the miss path)
+	uint64_t writebacks_on_miss_path;
+
+	// dirty pages written to disk by the cleanup scheduler and force_write, (these writes are not on the miss path)
+	uint64_t writebacks_by_cleanup;
+
+	// pages requested using request_page_prefetch
+	uint64_t pages_prefetched;
+
+	// prefetched pages, whose prefetch was cancelled before they were pushed to the bbq
+	uint64_t prefetched_pages_cancelled;
+
+	// pages read ahead, on detecting a sequential stream of page accesses
+	uint64_t pages_read_ahead;
+
+	// pages that were read from disk (prefetched or read ahead) but were never used,
+	// the cleanup scheduler returned them to the bufferpool after unused_prefetched_page_return_in_ms
+	uint64_t unused_prefetched_pages;
+
+	// calls to acquire a writer lock, that were paused (or made to wait), because there were too many dirty pages
+	uint64_t writers_throttled;
+
+	// pages read from disk, whose checksum footer did not match their contents (counted only with page checksums enabled)
+	uint64_t checksum_failures;
+
+	// pages written to (and read from) disk in their compressed form, with page compression enabled
+	uint64_t pages_written_compressed;
+	uint64_t pages_read_compressed;
+
+	// clean evicted pages put in the compressed_page_cache, and the page misses served from it (instead of the disk)
+	uint64_t pages_put_in_compressed_cache;
+	uint64_t compressed_cache_hits;
+
+	// clean evicted pages written to the l2_page_cache, and the page misses served from it (instead of the heap file)
+	uint64_t pages_written_to_l2_cache;
+	uint64_t l2_cache_hits;
+
+	// the page misses on the holes of the heap file, served by zero filling the frame (with hole detection enabled)
+	uint64_t hole_pages_zero_filled;
+};
+
+// fills stats with the current values of all the counters of the bufferpool
+// the counters are read without stopping the bufferpool, so they may be a little off from each other
+void get_bufferpool_stats(bufferpool* buffp, bufferpool_stats* stats);
+
+// the latencies, that the bufferpool records in latency_histograms
+typedef enum bufferpool_latency bufferpool_latency;
+enum bufferpool_latency
+{
+	// the complete acquire_page_with_*_lock* call, including the wait for the page to be read from disk, and for the lock on the page
+	ACQUIRE_PAGE_LATENCY = 0,
+
+	// the time a page_request waits in the page_request_prioritizer, before an io thread starts fulfilling it (queueing delay)
+	PAGE_REQUEST_QUEUE_LATENCY,
+
+	// the time taken by a read of a page from the disk (device latency)
+	DISK_READ_LATENCY,
+
+	// the time taken by a write of a page to the disk (device latency)
+	DISK_WRITE_LATENCY,
+
+	// the time a force_write call waits for the page to be written to disk
+	FORCE_WRITE_WAIT_LATENCY,
+
+	BUFFERPOOL_LATENCIES_COUNT
+};
+
+// fills hist with all the recorded latencies of the given kind, use get_percentile_of_latency_histogram() to read percentiles from it
+void get_bufferpool_latency_histogram(bufferpool* buffp, bufferpool_latency latency, latency_histogram* hist);
+
+// starts recording all the page acquires, releases, prefetches, read aheads and evictions to the trace file (format in page_access_trace.h)
+// the events are recorded in a ring buffer of trace_buffer_size events, and written to the file by a separate thread, the events are dropped if it is full
+// it returns 0, if the bufferpool is already being traced, or if the trace file could not be created
+int start_page_access_trace(bufferpool* buffp, char* trace_file_name, uint32_t trace_buffer_size);
+
+// stops recording the trace, and completes the trace file, returns 0 if the bufferpool was not being traced
+int stop_page_access_trace(bufferpool* buffp);
+
 // deletes the buffer pool manager, that will maintain a heap file given by the name heap_file_name
 void delete_bufferpool(bufferpool* buffp);
 
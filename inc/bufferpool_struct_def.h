@@ -13,9 +13,24 @@
 #include<page_request_tracker.h>
 #include<page_request_prioritizer.h>
 
+#include<scan_ring.h>
+#include<shared_scan_coordinator.h>
+#include<read_ahead_detector.h>
+#include<dirty_page_throttle.h>
+#include<page_compression.h>
+#include<compressed_page_cache.h>
+#include<l2_page_cache.h>
+#include<page_hole_map.h>
+
+#include<stats_shards.h>
+#include<page_access_tracer.h>
+
 #include<executor.h>
 
 typedef struct bufferpool bufferpool;
+// the reservations of the disk space are made in chunks of atleast this many bytes, so that the heap file is made of large extents
+#define DISK_RESERVATION_CHUNK_SIZE (8 * 1024 * 1024)
+
 struct bufferpool
 {
 	// ******** Memories section start
@@ -62,15 +77,68 @@ struct bufferpool
 
 	page_request_prioritizer* rq_prioritizer;
 
+	shared_scan_coordinator* scan_coordinator;
+
+	// detects sequential streams of page misses and reads ahead the pages of the stream
+	// it is NULL, if the bufferpool is too small to read ahead
+	read_ahead_detector* ra_detector;
+
+	// counts the dirty pages, and paces the writers when there are too many of them
+	dirty_page_throttle* dirty_throttle;
+
+	// the number of blocks to read for each page, when the pages are stored compressed, it is NULL if page compression is not enabled
+	page_extent_map* extent_map;
+
+	// the second tier of the bufferpool, it holds the clean evicted pages compressed in memory (upto its bytes_budget, which is 0 by default)
+	compressed_page_cache* compressed_cache;
+
+	// the victim cache of the bufferpool in a second (faster) file, it is NULL if it is not configured
+	l2_page_cache* l2_cache;
+
+	// the pages of the heap file that were never written (holes), it is NULL if hole detection is not enabled
+	page_hole_map* hole_map;
+
+	// all the pages below this page_id have been preallocated by reserve_pages_on_disk, or freed since by free_pages_on_disk (which never moves it back), it is protected by the reservation_lock
+	PAGE_ID reserved_upto_page_id;
+	pthread_mutex_t reservation_lock;
+
+	// if not NULL, the resident pages are dumped to this file by delete_bufferpool, for a warm restart
+	char* resident_pages_dump_file_name;
+
+	// the statistics counters of the bufferpool, sharded by thread
+	stats_shards* stats;
+
+	// the tracer recording the page accesses, it is NULL, if the bufferpool is not being traced
+	page_access_tracer* tracer;
+
+	// the number of threads that are recording in the tracer right now, the tracer can be stopped only after this count reaches 0
+	uint32_t tracer_users;
+
 	// ******** Necessary custom datastructures end
 
 	// ******** Threads section start
 
-	// This is the main multithread fixed thread count executor, 
-	// responsible to write dirty pages to disk and fetch new pages when there are pending page requests
-	executor* io_dispatcher;
+	// the io_dispatcher is made of two fixed thread count executors, so that the page reads are never queued behind a burst of page writes
+
+	// responsible to fetch new pages when there are pending page requests (it also writes the dirty victims, that it replaces)
+	executor* read_io_dispatcher;
+
+	// responsible to write dirty pages to disk, that are queued for clean up (by the cleanup scheduler or by force_write)
+	executor* write_io_dispatcher;
+
+	// if set, the write_io_dispatcher copies the page to a staging buffer (under a brief read lock) and writes the copy to disk,
+	// so that the writers of the page do not wait for the disk write
+	volatile int shadow_copy_writeback;
+
+	// one page sized staging buffer for each thread of the write_io_dispatcher, a thread claims its buffer on its first shadow copy writeback
+	void* writeback_staging_memories;
+	uint8_t write_io_thread_count;
+	uint32_t writeback_staging_memories_claimed;
+
+	// if set, the pages are stamped with a checksum footer before they are written, and their footers are verified after they are read
+	volatile int page_checksums;
 
-	// single thread that queues dirty pages to io_dispatcher for clean up, at a constant rate
+	// single thread that queues dirty pages to write_io_dispatcher for clean up, at a constant rate
 	job* cleanup_scheduler;
 	promise* cleanup_scheduler_completion_promise;
 
@@ -0,0 +1,75 @@
+#ifndef COMPRESSED_PAGE_CACHE_H
+#define COMPRESSED_PAGE_CACHE_H
+
+#include<buffer_pool_man_types.h>
+
+#include<pthread.h>
+
+#include<hashmap.h>
+#include<linkedlist.h>
+
+/*
+	The compressed_page_cache is a second tier of the bufferpool, in memory, that holds the clean pages evicted from the bufferpool, LZ4 compressed
+	so that a page miss, on a page that was evicted recently, costs a decompression (a few microseconds) instead of a disk read
+
+	it is an exclusive cache, a page is taken out of it (and it is not held by it anymore), when it is brought back in to the bufferpool
+	so a page is never both in the bufferpool and in the compressed_page_cache, and the compressed_page_cache never holds a stale copy of a page,
+	as only the bufferpool modifies the pages, and the pages are put in the compressed_page_cache only after they are written to disk
+	the compressed pages are evicted in the order they were put in it (which is also their lru order, since a used page leaves the cache), to stay within the bytes_budget
+	the pages that do not compress to atleast 7/8 of their size, are not put in the cache
+*/
+
+typedef struct compressed_page compressed_page;
+struct compressed_page
+{
+	PAGE_ID page_id;
+
+	// the size of the LZ4 compressed page in data
+	uint32_t compressed_size;
+
+	// node in the bucket of the compressed_page_map
+	llnode map_node;
+
+	// node in the compressed_pages_lru
+	llnode lru_node;
+
+	char data[];
+};
+
+typedef struct compressed_page_cache compressed_page_cache;
+struct compressed_page_cache
+{
+	// protects all of the below attributes
+	pthread_mutex_t cache_lock;
+
+	// page_id vs compressed_page
+	hashmap compressed_page_map;
+
+	// the compressed_pages, from the oldest (at the head) to the newest
+	linkedlist compressed_pages_lru;
+
+	// the memory (the compressed pages and their compressed_page structs) held by the cache, and its limit
+	uint64_t bytes_used;
+	uint64_t bytes_budget;
+};
+
+// the cache is created with a bytes_budget of 0, no pages are put in it, until its budget is set
+compressed_page_cache* get_compressed_page_cache();
+
+// sets the bytes_budget, and evicts the oldest compressed pages, until the cache fits in it
+void set_compressed_page_cache_bytes_budget(compressed_page_cache* cpc, uint64_t bytes_budget);
+
+// compresses and puts the page in the cache, replacing any older copy of the page
+// returns 0, if the page was not put in the cache (the cache has no budget, or the page did not compress enough)
+int put_in_compressed_page_cache(compressed_page_cache* cpc, PAGE_ID page_id, const void* page_memory, SIZE_IN_BYTES page_size);
+
+// if the page is in the cache, it is removed from the cache and decompressed in to page_memory, and 1 is returned
+// else (or if it fails to decompress) it returns 0
+int take_from_compressed_page_cache(compressed_page_cache* cpc, PAGE_ID page_id, void* page_memory, SIZE_IN_BYTES page_size);
+
+// removes the page from the cache (if it is there), without decompressing it
+void remove_from_compressed_page_cache(compressed_page_cache* cpc, PAGE_ID page_id);
+
+void delete_compressed_page_cache(compressed_page_cache* cpc);
+
+#endif
\ No newline at end of file
@@ -51,6 +51,19 @@ int write_blocks_to_disk(dbfile* dbfile_p, void* blocks_in_main_memory, BLOCK_ID
 // reads a given number of blocks starting with starting_block_id, and store their contents to memory location pointed to by blocks_in_main_memory
 int read_blocks_from_disk(dbfile* dbfile_p, void* blocks_in_main_memory, BLOCK_ID starting_block_id, BLOCK_COUNT num_blocks_to_read);
 
+// finds the first range of blocks holding data, at or after from_block_id, like find_data_blocks in disk_access_functions.h
+int find_data_blocks_on_disk(dbfile* dbfile_p, BLOCK_ID from_block_id, BLOCK_ID* data_start_block_id, BLOCK_ID* data_end_block_id);
+
+// sets *block_count to the number of blocks in the file, as per its current size, unlike get_block_count and get_size, it sees the writes since the file was opened
+// returns 0 for success, -1 on error
+int get_current_block_count(dbfile* dbfile_p, BLOCK_COUNT* block_count);
+
+// preallocates the disk space for the given blocks, like allocate_blocks in disk_access_functions.h
+int allocate_blocks_on_disk(dbfile* dbfile_p, BLOCK_ID starting_block_id, BLOCK_COUNT num_blocks_to_allocate);
+
+// punches a hole at the given blocks, freeing their disk space, like deallocate_blocks in disk_access_functions.h
+int deallocate_blocks_on_disk(dbfile* dbfile_p, BLOCK_ID starting_block_id, BLOCK_COUNT num_blocks_to_deallocate);
+
 int close_dbfile(dbfile* dbfile_p);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,67 @@
+#ifndef DIRTY_PAGE_THROTTLE_H
+#define DIRTY_PAGE_THROTTLE_H
+
+#include<buffer_pool_man_types.h>
+
+#include<page_entry.h>
+
+#include<pthread.h>
+
+/*
+	The dirty_page_throttle keeps a count of the dirty page_entries of the bufferpool, and paces the writers when there are too many of them
+	(similar to the balance_dirty_pages of the linux page cache)
+
+	with dirty_pages_limit = L (0 means no limit)
+		upto L/2 dirty pages                : the writers are never paused, the cleanup scheduler writes the old dirty pages at its own rate
+		above L/2 dirty pages               : the writers push the writeback cursor, that queues dirty pages for clean up irrespective of their age
+		above 3L/4 (the setpoint) dirty pages : additionally, the writers are paused, for upto MAX_WRITER_PAUSE_ms, proportionally to how far above the setpoint the dirty pages are
+		L or more dirty pages               : the writers wait until the write io_dispatcher brings the dirty pages below L,
+		                                      but for atmost MAX_WRITER_OVER_LIMIT_WAIT_PERIODS * MAX_WRITER_PAUSE_ms, after which they proceed over the limit
+	so that the latency of the writers degrades smoothly, instead of every page miss having to write a dirty victim, once the bufferpool is full of dirty pages
+*/
+
+#define MAX_WRITER_PAUSE_ms 10
+
+// the writers are throttled while they may hold latches on other pages (that the write io_dispatcher may be waiting to lock, to clean them up)
+// so a writer at or over the limit never waits for more than these many MAX_WRITER_PAUSE_ms periods
+#define MAX_WRITER_OVER_LIMIT_WAIT_PERIODS 4
+
+typedef struct dirty_page_throttle dirty_page_throttle;
+struct dirty_page_throttle
+{
+	// the number of page_entries that have their IS_DIRTY bit set, only updated atomically
+	PAGE_COUNT dirty_pages_count;
+
+	// the maximum number of dirty pages, 0 means unlimited
+	PAGE_COUNT dirty_pages_limit;
+
+	// the index of the page_entry, from where the writeback cursor continues queuing the dirty pages for clean up
+	PAGE_COUNT writeback_cursor;
+
+	// only 1 writer pushes the writeback cursor at a time, the others do not wait for it
+	pthread_mutex_t writeback_cursor_lock;
+
+	// the writers wait on this condition variable while dirty_pages_count >= dirty_pages_limit
+	pthread_mutex_t over_limit_lock;
+	pthread_cond_t over_limit_wait;
+	uint32_t over_limit_waiters;
+};
+
+dirty_page_throttle* get_dirty_page_throttle();
+
+void set_dirty_pages_limit(dirty_page_throttle* dpt, PAGE_COUNT dirty_pages_limit);
+
+// the below two functions must be used to set/reset the IS_DIRTY bit of a page_entry, they keep the dirty_pages_count
+// the page_entry_lock of the page_entry must be held by the caller
+void set_page_entry_dirty(dirty_page_throttle* dpt, page_entry* page_ent);
+void reset_page_entry_dirty(dirty_page_throttle* dpt, page_entry* page_ent);
+
+typedef struct bufferpool bufferpool;
+
+// must be called by the writers before they acquire a writer lock on a page, without holding any locks of the bufferpool (the caller may hold latches on other pages)
+// it pushes the writeback cursor and pauses (or waits for a bounded time) as described above, it returns 1, if the writer was paused
+int balance_dirty_pages(bufferpool* buffp);
+
+void delete_dirty_page_throttle(dirty_page_throttle* dpt);
+
+#endif
\ No newline at end of file
@@ -45,6 +45,23 @@ int read_blocks(int db_fd, void* blocks_in_main_memory, BLOCK_ID block_id, BLOCK
 // returs 0 for success, -1 on error
 int write_blocks(int db_fd, void* blocks_in_main_memory, BLOCK_ID block_id, BLOCK_COUNT block_count, SIZE_IN_BYTES block_size);
 
+// finds the first range of blocks that hold data, at or after the from_block_id, using SEEK_DATA and SEEK_HOLE, the blocks in between are holes (never written)
+// the range is [*data_start_block_id, *data_end_block_id), a block that is only partially data is considered to be data
+// returns 1 if a range is found, 0 if there is no data at or after from_block_id, and -1 if the file system can not report holes
+int find_data_blocks(int db_fd, BLOCK_ID from_block_id, BLOCK_ID* data_start_block_id, BLOCK_ID* data_end_block_id, SIZE_IN_BYTES block_size);
+
+// sets *block_count to the number of blocks in the file, as per its current size (a partial last block is counted as a block)
+// returns 0 for success, -1 on error
+int get_file_block_count(int db_fd, BLOCK_COUNT* block_count, SIZE_IN_BYTES block_size);
+
+// allocates the disk space for the blocks (using fallocate), the blocks read as zeros, until they are written, the file is extended if required
+// returns 0 for success, -1 on error (or if the file system can not preallocate)
+int allocate_blocks(int db_fd, BLOCK_ID block_id, BLOCK_COUNT block_count, SIZE_IN_BYTES block_size);
+
+// frees the disk space of the blocks, by punching a hole (using fallocate), the blocks read as zeros from then on, the size of the file does not change
+// returns 0 for success, -1 on error (or if the file system can not punch holes)
+int deallocate_blocks(int db_fd, BLOCK_ID block_id, BLOCK_COUNT block_count, SIZE_IN_BYTES block_size);
+
 // close the given open file discriptor of the
 // returns 0 on success, else returns 1
 int close_db_file(int db_fd);
@@ -10,6 +10,10 @@ void queue_job_for_page_request(bufferpool* buffp);
 
 void queue_page_entry_clean_up_if_dirty(bufferpool* buffp, page_entry* page_ent);
 
+// same as above, but the caller must hold the page_entry_lock of the page_entry
+// returns 1, if the page_entry was queued for clean up
+int queue_page_entry_clean_up_if_dirty_unsafe(bufferpool* buffp, page_entry* page_ent);
+
 void queue_and_wait_for_page_entry_clean_up_if_dirty(bufferpool* buffp, page_entry* page_ent);
 
 #endif
\ No newline at end of file
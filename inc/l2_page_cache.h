@@ -0,0 +1,97 @@
+#ifndef L2_PAGE_CACHE_H
+#define L2_PAGE_CACHE_H
+
+#include<buffer_pool_man_types.h>
+
+#include<dbfile.h>
+
+#include<pthread.h>
+
+#include<hashmap.h>
+
+/*
+	The l2_page_cache is a victim cache of the bufferpool, in a second (faster) file, like a file on an SSD in front of a heap file on a HDD or on network block storage
+
+	the l2 file is divided into l2_pages slots of a page each, the clean pages evicted from the bufferpool are copied in to a slot (asynchronously, by the write io_dispatcher),
+	and a page miss reads the page from its slot (if it has one), instead of the heap file
+	the index (page_id vs slot) is only in memory, so the l2_page_cache starts empty with every bufferpool, the contents of the l2 file are never trusted
+
+	the slots are replaced in CLOCK order, a slot that was read since the hand last passed it gets a second chance
+	a slot holds the same contents as the page in the heap file, so it is invalidated whenever its page is written to the heap file
+	a slot is not read until its write completes (L2_SLOT_BEING_WRITTEN), and it is not replaced while it is being read (pinned_by_count > 0)
+*/
+
+typedef enum l2_slot_state l2_slot_state;
+enum l2_slot_state
+{
+	L2_SLOT_FREE,
+	L2_SLOT_BEING_WRITTEN,
+	L2_SLOT_VALID,
+};
+
+typedef struct l2_slot l2_slot;
+struct l2_slot
+{
+	// the page held (or being written) in this slot, it is in the l2_slot_map only if the slot is not free
+	PAGE_ID page_id;
+
+	l2_slot_state state;
+
+	// set if the page was invalidated, while it was being written to (or read from) the slot, the slot is freed once the write (or the read) completes
+	int is_invalidated;
+
+	// set when the page is read from the slot, reset when the CLOCK hand passes the slot
+	int is_referenced;
+
+	// the number of threads reading the page from this slot
+	uint32_t pinned_by_count;
+};
+
+typedef struct l2_page_cache l2_page_cache;
+struct l2_page_cache
+{
+	// the l2 file and its geometry
+	dbfile* l2_file;
+	PAGE_COUNT l2_pages;
+	BLOCK_COUNT blocks_per_page;
+
+	// protects all the slots, the l2_slot_map and the clock_hand
+	pthread_mutex_t l2_lock;
+
+	// the slot at index i, is the i-th page sized slot of the l2 file
+	l2_slot* slots;
+
+	// page_id vs l2_slot
+	hashmap l2_slot_map;
+
+	PAGE_COUNT clock_hand;
+
+	// the number of slots being written, new slots are not reserved, when there are MAX_PENDING_L2_SLOT_WRITES of them
+	uint32_t pending_slot_writes;
+};
+
+#define MAX_PENDING_L2_SLOT_WRITES 64
+
+// the reservations of slots fail with this value
+#define NO_L2_SLOT 0xffffffff
+
+// opens (or creates) the l2 file, and sizes it to hold l2_pages pages, returns NULL if it could not be opened, or if its block size does not divide the page_size
+l2_page_cache* get_l2_page_cache(char* l2_file_name, PAGE_COUNT l2_pages, SIZE_IN_BYTES page_size);
+
+// reserves a slot for the page, replacing the slot at the CLOCK hand, the slot must then be written using write_to_l2_page_cache_slot
+// returns NO_L2_SLOT, if the page already has a slot (or is being written to one), or if no slot could be replaced right now
+uint32_t reserve_l2_page_cache_slot(l2_page_cache* l2pc, PAGE_ID page_id);
+
+// writes the page to the slot that was reserved for it, the slot is readable once this function returns (unless the page was invalidated in the meantime)
+// page_memory must be aligned to the block size of the l2 file
+void write_to_l2_page_cache_slot(l2_page_cache* l2pc, uint32_t slot_index, const void* page_memory);
+
+// reads the page from its slot in to page_memory, returns 0, if the page does not have a readable slot (or if the read fails)
+int read_from_l2_page_cache(l2_page_cache* l2pc, PAGE_ID page_id, void* page_memory);
+
+// must be called when the page is written to the heap file, the slot of the page (if any) is freed, as it now holds stale contents
+void invalidate_in_l2_page_cache(l2_page_cache* l2pc, PAGE_ID page_id);
+
+void delete_l2_page_cache(l2_page_cache* l2pc);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,45 @@
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+
+#include<buffer_pool_man_types.h>
+
+/*
+	A latency_histogram counts latencies (in nanoseconds) in log bucketed buckets (like an HDR histogram)
+
+	the latencies are bucketed by their highest set bit, and then each power of 2 is further split linearly in 2^LATENCY_HISTOGRAM_SUB_BUCKET_BITS sub buckets
+	so a latency is reported with a relative error of atmost 1 / 2^LATENCY_HISTOGRAM_SUB_BUCKET_BITS (12.5 %), for any latency in the range
+	latencies upto 2^LATENCY_HISTOGRAM_MAX_LATENCY_BITS nanoseconds (about 18 minutes) are counted, the larger ones are counted in the last bucket
+
+	recording a latency is only an atomic increment of its bucket, so the histogram can be recorded into, by multiple threads concurrently
+*/
+
+#define LATENCY_HISTOGRAM_SUB_BUCKET_BITS 3
+
+#define LATENCY_HISTOGRAM_SUB_BUCKETS (1 << LATENCY_HISTOGRAM_SUB_BUCKET_BITS)
+
+#define LATENCY_HISTOGRAM_MAX_LATENCY_BITS 40
+
+#define LATENCY_HISTOGRAM_BUCKETS ((LATENCY_HISTOGRAM_MAX_LATENCY_BITS - LATENCY_HISTOGRAM_SUB_BUCKET_BITS + 1) * LATENCY_HISTOGRAM_SUB_BUCKETS)
+
+typedef struct latency_histogram latency_histogram;
+struct latency_histogram
+{
+	uint64_t buckets[LATENCY_HISTOGRAM_BUCKETS];
+};
+
+void initialize_latency_histogram(latency_histogram* lh_p);
+
+// counts the latency in its bucket
+void record_in_latency_histogram(latency_histogram* lh_p, TIME_ns latency);
+
+// adds all the counts of src into dest
+void merge_latency_histogram(latency_histogram* dest, const latency_histogram* src);
+
+// returns the number of latencies recorded in the histogram
+uint64_t get_count_of_latency_histogram(const latency_histogram* lh_p);
+
+// returns the latency (in nanoseconds), that percentile % of the recorded latencies are lesser than or equal to, percentile must be in range [0.0, 100.0]
+// the returned latency is the largest latency of its bucket, it returns 0, if the histogram is empty
+TIME_ns get_percentile_of_latency_histogram(const latency_histogram* lh_p, double percentile);
+
+#endif
\ No newline at end of file
@@ -69,6 +69,10 @@ void mark_as_not_yet_used(lru* lru_p, page_entry* page_ent);
 // call this method once a used page will not be used again in near future
 void mark_as_evictable(lru* lru_p, page_entry* page_ent);
 
+// calls operation on all the used page_entries in the lru (i.e. not on the free ones), in the order in which they would be picked for replacement
+// the lru_lock is held, while the operation is called, so the operation must not call any function of the lru
+void for_each_used_page_entry_in_lru(lru* lru_p, void (*operation)(const void* page_ent, const void* additional_params), const void* additional_params);
+
 void delete_lru(lru* lru_p);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,20 @@
+#ifndef LZ4_CODEC_H
+#define LZ4_CODEC_H
+
+#include<buffer_pool_man_types.h>
+
+/*
+	An in-tree codec for the LZ4 block format (the format of LZ4_compress_default / LZ4_decompress_safe, without the LZ4 frame)
+
+	the compressor is a simple greedy one (a single hash table of the positions of the 4 byte sequences, no chains),
+	it compresses a little worse than the reference implementation, but its output is decoded by any LZ4 block decoder
+	the decompressor validates every length and offset against the sizes of the source and the destination, so a corrupt input can not overrun them
+*/
+
+// returns the size of the compressed data written to dst, or 0 if it does not fit in dst_capacity bytes
+uint32_t lz4_compress(const void* src, uint32_t src_size, void* dst, uint32_t dst_capacity);
+
+// returns the size of the decompressed data written to dst, or -1 if src is not valid LZ4 block data, or if it decompresses to more than dst_capacity bytes
+int64_t lz4_decompress(const void* src, uint32_t src_size, void* dst, uint32_t dst_capacity);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,22 @@
+#ifndef NUMA_PLACEMENT_H
+#define NUMA_PLACEMENT_H
+
+#include<stddef.h>
+
+/*
+	The frames of the bufferpool are a single mmap, populated by the thread that calls get_bufferpool, so all of them land on the NUMA node of that thread
+	and on a multi socket machine, the page hits of the threads on all the other nodes are remote memory accesses
+
+	interleave_memory_across_numa_nodes() spreads such memory, page by page (round robin), over all the NUMA nodes that have memory, migrating the pages that are already populated
+	so every thread sees the same (average) latency for the frames, and the memory bandwidth of all the nodes is used
+	it uses the mbind syscall directly (there is no dependency on libnuma), and it does nothing on a machine with a single NUMA node
+*/
+
+// returns the number of NUMA nodes that have memory, as listed in /sys/devices/system/node/has_memory, it is 1 if it can not be read
+int get_numa_nodes_with_memory_count();
+
+// interleaves the pages of the memory (it must be page aligned, like the mmap-ed memory) across all the NUMA nodes that have memory
+// returns 1 if the memory was interleaved, and 0 if there is only one NUMA node (nothing to do), or if the mbind syscall failed
+int interleave_memory_across_numa_nodes(void* memory, size_t size);
+
+#endif
\ No newline at end of file
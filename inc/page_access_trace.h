@@ -0,0 +1,88 @@
+#ifndef PAGE_ACCESS_TRACE_H
+#define PAGE_ACCESS_TRACE_H
+
+#include<buffer_pool_man_types.h>
+
+/*
+	This is the format of the page access trace files, written by the bufferpool when start_page_access_trace() is called
+
+	a trace file is a page_access_trace_file_header, followed by page_access_trace_events, until the end of the file
+	all the fields are written in the byte order of the machine that wrote the trace
+	the events are written in the order in which they were recorded, which is the order of their timestamps, except for the events recorded concurrently
+*/
+
+#define PAGE_ACCESS_TRACE_MAGIC 0x42505452
+
+#define PAGE_ACCESS_TRACE_VERSION 1
+
+typedef struct page_access_trace_file_header page_access_trace_file_header;
+struct page_access_trace_file_header
+{
+	// must be PAGE_ACCESS_TRACE_MAGIC
+	uint32_t magic;
+
+	// must be PAGE_ACCESS_TRACE_VERSION
+	uint32_t version;
+
+	// size of each page_access_trace_event in the file
+	uint32_t event_size;
+
+	// attributes of the bufferpool that was traced
+	uint32_t page_size;
+	uint32_t pages_in_bufferpool;
+
+	uint32_t reserved;
+
+	// number of events written to the trace file
+	uint64_t events_written;
+
+	// number of events that could not be recorded, because the trace buffer was full
+	uint64_t events_dropped;
+};
+
+typedef enum page_access_trace_event_type page_access_trace_event_type;
+enum page_access_trace_event_type
+{
+	// a page was acquired with a lock (latch_mode and is_miss are valid)
+	ACQUIRE_EVENT = 0,
+
+	// a page lock was released (latch_mode and okay_to_evict are valid)
+	RELEASE_EVENT = 1,
+
+	// a page was requested for prefetch, by the user
+	PREFETCH_EVENT = 2,
+
+	// a page was requested for read ahead, by the bufferpool
+	READ_AHEAD_EVENT = 3,
+
+	// a page was evicted from the bufferpool, to bring in some other page
+	EVICTION_EVENT = 4,
+};
+
+typedef struct page_access_trace_event page_access_trace_event;
+struct page_access_trace_event
+{
+	// monotonic timestamp (CLOCK_MONOTONIC) in nanoseconds
+	uint64_t timestamp_ns;
+
+	// a small number given to each thread that recorded an event, starting with 1
+	uint32_t thread_id;
+
+	uint32_t page_id;
+
+	// value of page_access_trace_event_type
+	uint8_t event_type;
+
+	// value of page_latch_mode (from bufferpool.h) that the page was acquired or released with
+	uint8_t latch_mode;
+
+	// 1, if the acquire had to wait for the page to be read from disk
+	uint8_t is_miss;
+
+	// the okay_to_evict hint passed to the release of the page
+	uint8_t okay_to_evict;
+
+	uint32_t reserved;
+};
+
+#endif
\ No newline at end of file
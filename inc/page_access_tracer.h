@@ -0,0 +1,73 @@
+#ifndef PAGE_ACCESS_TRACER_H
+#define PAGE_ACCESS_TRACER_H
+
+#include<buffer_pool_man_types.h>
+
+#include<page_access_trace.h>
+
+#include<job.h>
+
+/*
+	The page_access_tracer records page_access_trace_events in a bounded ring buffer, and a writer job writes them to the trace file
+
+	the ring buffer is a multi producer single consumer queue, each slot has a sequence number
+	a producer reserves a slot by a compare and swap on the reserve_position, writes its event and then publishes the slot by updating its sequence
+	the producers never wait, if the ring buffer is full, the event is dropped (and counted in events_dropped)
+	the writer job is the only consumer, it writes the published events to the trace file in batches
+*/
+
+typedef struct trace_slot trace_slot;
+struct trace_slot
+{
+	// the slot holds an event that can be consumed, only if its sequence is 1 more than the position being consumed
+	uint64_t sequence;
+
+	page_access_trace_event event;
+};
+
+typedef struct page_access_tracer page_access_tracer;
+struct page_access_tracer
+{
+	// number of slots in the ring buffer, it is a power of 2
+	uint32_t ring_size;
+
+	trace_slot* slots;
+
+	// the position of the next slot to be reserved by the producers
+	uint64_t reserve_position __attribute__((aligned(CACHE_LINE_SIZE)));
+
+	uint64_t events_dropped;
+
+	// the position of the next slot to be consumed by the writer job, it is accessed only by the writer job
+	uint64_t consume_position __attribute__((aligned(CACHE_LINE_SIZE)));
+
+	FILE* trace_file;
+
+	page_access_trace_file_header file_header;
+
+	// this variable is set to make the writer job write all the remaining events and quit
+	volatile int stop_called;
+
+	job* writer_job;
+	promise* writer_completion_promise;
+};
+
+// returns NULL, if the trace file could not be created
+// the ring_size is rounded up to a power of 2
+page_access_tracer* start_page_access_tracer(char* trace_file_name, uint32_t ring_size, uint32_t page_size, uint32_t pages_in_bufferpool);
+
+// records the event in the ring buffer, the timestamp and the thread_id of the event are filled in by this function
+// it never blocks, it may be called by any number of threads concurrently
+void record_in_page_access_tracer(page_access_tracer* pat_p, page_access_trace_event event);
+
+// stops the writer job (after it has written all the events), closes the trace file and deletes the tracer
+// no one must be recording in the tracer, when this function is called
+void stop_page_access_tracer(page_access_tracer* pat_p);
+
+typedef struct bufferpool bufferpool;
+
+// records the event, only if the bufferpool is being traced
+// it only reads the tracer pointer of the bufferpool, if the bufferpool is not being traced
+void trace_page_access(bufferpool* buffp, page_access_trace_event_type event_type, PAGE_ID page_id, uint8_t latch_mode, uint8_t is_miss, uint8_t okay_to_evict);
+
+#endif
\ No newline at end of file
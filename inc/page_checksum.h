@@ -0,0 +1,47 @@
+#ifndef PAGE_CHECKSUM_H
+#define PAGE_CHECKSUM_H
+
+#include<buffer_pool_man_types.h>
+
+/*
+	Page checksums detect the torn writes and the bit rot of the pages, between their write to the disk and their read back from it
+
+	with page checksums enabled, the last PAGE_CHECKSUM_FOOTER_SIZE bytes of every page are reserved for the page_checksum_footer
+	the footer is stamped by the io thread, right before the page is written, and it is verified by the io thread, right after the page is read
+	the checksum is the CRC32C (castagnoli) of the page excluding the checksum itself, so it also covers the magic of the footer
+
+	CRC32C is computed with the crc32 instruction of SSE4.2 (3 streams interleaved to hide its latency), when the cpu supports it,
+	else with a portable slicing-by-8 table implementation, both give the same checksum
+*/
+
+#define PAGE_CHECKSUM_FOOTER_MAGIC 0x43524343
+
+typedef struct page_checksum_footer page_checksum_footer;
+struct page_checksum_footer
+{
+	// tells a stamped page apart from a page that was never written with a checksum
+	uint32_t magic;
+
+	// CRC32C of all the bytes of the page before the checksum
+	uint32_t checksum;
+};
+
+#define PAGE_CHECKSUM_FOOTER_SIZE sizeof(page_checksum_footer)
+
+// returns the CRC32C of the data, continuing from the crc of the data before it (pass 0 for the first call)
+uint32_t get_crc32c(uint32_t crc, const void* data, size_t data_size);
+
+// the portable table implementation of get_crc32c, even if the cpu supports SSE4.2
+uint32_t get_crc32c_portable(uint32_t crc, const void* data, size_t data_size);
+
+// returns 1, if get_crc32c uses the crc32 instruction of SSE4.2
+int is_crc32c_hardware_accelerated();
+
+// writes the footer at the end of the page, for the current contents of the page
+void stamp_page_checksum(void* page, SIZE_IN_BYTES page_size);
+
+// returns 1, if the footer at the end of the page matches the contents of the page
+// a page of all zeros (never written, or beyond the end of the file) is also considered valid
+int verify_page_checksum(const void* page, SIZE_IN_BYTES page_size);
+
+#endif
\ No newline at end of file
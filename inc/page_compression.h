@@ -0,0 +1,76 @@
+#ifndef PAGE_COMPRESSION_H
+#define PAGE_COMPRESSION_H
+
+#include<buffer_pool_man_types.h>
+
+#include<dbfile.h>
+
+#include<pthread.h>
+
+/*
+	With page compression, every page still has its own slot of number_of_blocks_per_page blocks in the heap file (the same slot as without compression),
+	but a page that compresses by atleast a block is stored in only the first few blocks of its slot, as a compressed_page_header followed by the LZ4 compressed page
+	so reading it transfers only those few blocks, this multiplies the effective read bandwidth of the device by the compression ratio (the rest of the slot is never read)
+	the pages that do not compress by a block are stored as they are, in their complete slot
+
+	the compressed pages are self describing, the compressed_page_header carries a magic, the page_id, the compressed size and the CRC32C of the compressed data
+	so the page_extent_map (the number of blocks to read, for each page) is only a hint, it is never trusted
+	if the hint is short (or the page was written uncompressed since), the rest of the page is read with a second read, and if it is missing the whole slot is read
+	the page_extent_map is kept in memory, and every change to it is also written to the extent map file (without syncing it), a stale extent map only costs extra reads
+*/
+
+#define COMPRESSED_PAGE_MAGIC 0x50345a4c
+
+typedef struct compressed_page_header compressed_page_header;
+struct compressed_page_header
+{
+	uint32_t magic;
+
+	// the page_id of the page, the compressed page is valid only in the slot of this page
+	PAGE_ID page_id;
+
+	// the size of the LZ4 compressed page, that follows this header
+	uint32_t compressed_size;
+
+	// the CRC32C of the LZ4 compressed page
+	uint32_t checksum;
+};
+
+typedef struct page_extent_map page_extent_map;
+struct page_extent_map
+{
+	// the number of blocks to read for each page_id (from the start of its slot), 0 means unknown (the whole slot is read)
+	uint16_t* blocks_to_read;
+
+	// the number of page_ids, that blocks_to_read has entries for, it grows as the higher page_ids are written
+	PAGE_COUNT page_ids_count;
+
+	// protects blocks_to_read and page_ids_count
+	pthread_mutex_t extent_map_lock;
+
+	// the extent map file, it is an array of uint16_t blocks_to_read, indexed by the page_id
+	int extent_map_fd;
+};
+
+// opens (or creates) the extent map file and loads it, returns NULL if the file could not be opened
+page_extent_map* get_page_extent_map(char* extent_map_file_name);
+
+// writes the page to its slot, compressed if it saves atleast a block, and sets *is_compressed accordingly
+// returns the number of bytes written (the page_size, even if fewer bytes were written for a compressed page), or a value <= 0 on an error
+int write_page_compressed(page_extent_map* pem, dbfile* dbfile_p, const void* page_memory, PAGE_ID page_id, BLOCK_ID start_block_id, BLOCK_COUNT number_of_blocks, int* is_compressed);
+
+// reads the page from its slot, decompressing it if it was stored compressed
+// returns the number of bytes of the page read (the page_size, even if fewer bytes were read for a compressed page), like read_blocks_from_disk
+// it sets *was_compressed to 1, if the page was stored compressed
+int read_page_compressed(page_extent_map* pem, dbfile* dbfile_p, void* page_memory, PAGE_ID page_id, BLOCK_ID start_block_id, BLOCK_COUNT number_of_blocks, int* was_compressed);
+
+// forgets the number of blocks to read for the page (its whole slot will be read), it must be called when the slot of the page is deallocated
+void forget_page_extent(page_extent_map* pem, PAGE_ID page_id);
+
+// page_memory holds the complete slot of the page (as read from the disk), if it holds a valid compressed page, it is decompressed in place and 1 is returned
+// else page_memory is left as is (it is an uncompressed page) and 0 is returned
+int decompress_page_in_place(void* page_memory, SIZE_IN_BYTES page_size, PAGE_ID page_id);
+
+void delete_page_extent_map(page_extent_map* pem);
+
+#endif
\ No newline at end of file
@@ -25,16 +25,28 @@ enum page_entry_flags
 
 	// this bit represents if a corresponding page entry has been queued for cleanup
 	IS_QUEUED_FOR_CLEANUP 	= 0b00000100,
+
+	// this bit is set while a shadow copy of the page is being written to disk, without holding any lock on the page_entry
+	// the page_entry must not be replaced (nor its page read again from disk) until this bit is reset
+	IS_BEING_WRITTEN		= 0b00001000,
 };
 
+/*
+	the page_entries are laid out in an array, one for each frame, and each of them is aligned to (and padded upto) a CACHE_LINE_SIZE
+	so the threads hitting pages in adjacent frames never write to the same cache line (no false sharing between the unrelated hot pages)
+
+	within a page_entry, the attributes are grouped by how they are accessed :
+	 * the first cache line holds the read mostly attributes, that change only when the frame is replaced,
+	   the page_id on it is read by every probe of the page_table (robinhood hashing compares the page_ids of the page_entries), so it is kept away from the writes of the page hits
+	 * then, starting on the next cache line, the attributes written on every page hit (the locks, the pin and usage counts, and the lru links)
+	 * and at the end, the cold attributes, used only by the io and the cleanup
+	the lru links can not be moved out of the page_entry (in to a separate cold array), since the linkedlists of the lru reach the page_entry from its llnode by offset
+*/
+
 typedef struct page_entry page_entry;
 struct page_entry
 {
-	// this lock ensures only 1 thread attempts to access the page_entry at any given moment
-	pthread_mutex_t page_entry_lock;
-
-
-
+	// read mostly attributes, written only when the page_entry is reset to a new page (with the page_entry_lock held)
 
 	// this is the page id of the page that the buffer pool is holding
 	PAGE_ID page_id;
@@ -48,17 +60,15 @@ struct page_entry
 	// you need to read number_of_blocks_in_page from start_block_id, to read all of the page from disk
 	BLOCK_COUNT number_of_blocks;
 
-
-
-
 	// pointer to the in-memory copy of the page
 	void* page_memory;
 
-	// this lock also ensures concurrency for attempts to read or write the page to/from the disk
-	rwlock page_memory_lock;
 
 
+	// hot attributes, written on every page hit
 
+	// this lock ensures only 1 thread attempts to access the page_entry at any given moment
+	pthread_mutex_t page_entry_lock __attribute__((aligned(CACHE_LINE_SIZE)));
 
 	// the flags field represents the current state of this page entry
 	// check page_entry_flags above
@@ -73,15 +83,8 @@ struct page_entry
 	// if a page has 0 usage count, for a long time after last io was performed, it becomes a very good candidate during page replacement by LRU 
 	uint32_t usage_count;
 
-	// this is the timestamp, when the last disk io operation was performed on this page_entry
-	TIMESTAMP_ms unix_timestamp_since_last_disk_io_in_ms;
-
-
-
-	// reader threads wait on this conditional wait while their force_write call is happenning
-	pthread_cond_t force_write_wait;
-
-
+	// this lock also ensures concurrency for attempts to read or write the page to/from the disk
+	rwlock page_memory_lock;
 
 	// linkedlist node for LRU
 	// protected by locks of LRU
@@ -91,7 +94,17 @@ struct page_entry
 	linkedlist* lru_list;
 	// the above two fields are related to lru, and will be protected under the mutec of lru (lru_lock mutex of lru) only
 	// these above two fields must not be used, checked outside lru, i.e. outside lru_lock
-};
+
+
+
+	// cold attributes, used only by the io and the cleanup
+
+	// this is the timestamp, when the last disk io operation was performed on this page_entry
+	TIMESTAMP_ms unix_timestamp_since_last_disk_io_in_ms;
+
+	// reader threads wait on this conditional wait while their force_write call is happenning
+	pthread_cond_t force_write_wait;
+} __attribute__((aligned(CACHE_LINE_SIZE)));
 
 void initialize_page_entry(page_entry* page_ent, void* page_memory);
 
@@ -124,10 +137,6 @@ int compare_page_entry_by_page_id(const void* page_ent1, const void* page_ent2);
 
 unsigned int hash_page_entry_by_page_id(const void* page_ent);
 
-int compare_page_entry_by_page_memory(const void* page_ent1, const void* page_ent2);
-
-unsigned int hash_page_entry_by_page_memory(const void* page_ent);
-
 #endif
 
 /*
@@ -0,0 +1,47 @@
+#ifndef PAGE_HOLE_MAP_H
+#define PAGE_HOLE_MAP_H
+
+#include<buffer_pool_man_types.h>
+
+#include<dbfile.h>
+
+#include<pthread.h>
+
+/*
+	The heap file is extended lazily, by the writes past its end, so its pages that were never written are holes in the (sparse) file
+	reading such a page still costs a complete disk read (of zeros), the page_hole_map remembers which pages may hold data, so that a page miss on a hole can be served by zero filling the frame
+
+	it is built once, when the heap file is opened, from the data ranges reported by the file system (SEEK_DATA and SEEK_HOLE), a page is allocated if any of its blocks holds data
+	and from then on, every page is marked allocated before it is written, so the page_hole_map may only err on the side of a page being allocated (it only costs a read)
+	this requires that no one else writes to the heap file, while the bufferpool is using it
+*/
+
+typedef struct page_hole_map page_hole_map;
+struct page_hole_map
+{
+	// protects both the attributes below
+	pthread_mutex_t hole_map_lock;
+
+	// bit i is set if the page i may hold data on disk, else the page i is a hole
+	uint64_t* allocated_pages;
+
+	// the number of page_ids that allocated_pages has bits for (a multiple of 64), all the higher page_ids are holes
+	PAGE_COUNT page_ids_count;
+};
+
+// builds the page_hole_map of the heap file, with number_of_blocks_per_page blocks in every page
+// returns NULL, if the file system of the heap file can not report its holes
+page_hole_map* get_page_hole_map(dbfile* dbfile_p, BLOCK_COUNT number_of_blocks_per_page);
+
+// returns 1, if the page has never been written (its contents on disk are all zeros)
+int is_page_hole(page_hole_map* phm, PAGE_ID page_id);
+
+// must be called before the page is written to the heap file
+void mark_page_allocated(page_hole_map* phm, PAGE_ID page_id);
+
+// must be called after a hole is punched at the page
+void mark_page_hole(page_hole_map* phm, PAGE_ID page_id);
+
+void delete_page_hole_map(page_hole_map* phm);
+
+#endif
\ No newline at end of file
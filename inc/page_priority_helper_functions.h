@@ -7,6 +7,8 @@
 
 int compare_page_priority(uint8_t page_priority1, uint8_t page_priority2);
 
+int compare_page_request_class(uint8_t request_class1, uint8_t request_class2);
+
 void priority_queue_index_change_callback(const void* page_req, unsigned int heap_index, const void* additional_params);
 
 // below function can be passed to the for_each of priority queue to increment all the priorities at once
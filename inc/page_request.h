@@ -25,6 +25,21 @@
 	this helps us to know when there is noone using this object and hence we can delete that request
 */
 
+// the class of a page_request, a page_request of a higher class is always fulfilled before the page_requests of the lower classes
+// the page_requests of the same class are fulfilled in the order of their page_request_priority
+typedef enum page_request_class page_request_class;
+enum page_request_class
+{
+	// speculative read ahead, issued by the bufferpool itself
+	READ_AHEAD_REQUEST = 0,
+
+	// prefetch, requested by the user using request_page_prefetch
+	PREFETCH_REQUEST = 1,
+
+	// a user thread is waiting for this page, to acquire lock on it
+	DEMAND_REQUEST = 2,
+};
+
 typedef struct page_request page_request;
 struct page_request
 {
@@ -36,9 +51,25 @@ struct page_request
 	// this variable needs to be protected under the mutex lock of the page_request prioritizer
 	uint8_t page_request_priority;
 
+	// the class of the page_request, it is compared before the page_request_priority, it can only be upgraded (when a demand request piggy-backs on a prefetch)
+	// this variable needs to be protected under the mutex lock of the page_request prioritizer
+	page_request_class request_class;
+
 	// this is the index of the page_request in the priority queue (max heap), managed and protected by the page_request_priotitizer
 	unsigned int index_in_priority_queue;
 
+	// this bit is set, once the page_request is popped from the priority queue, to be fulfilled by the io_dispatcher
+	// a dispatched page_request can not be cancelled, it is protected by the page_request_prioritizer
+	int is_dispatched;
+
+	// this is the frame, that the creator of the request would like to be replaced to fulfill this request (example the frame of a scan_ring)
+	// it is NULL, if any frame given by the lru would do, it is only a hint, the io_dispatcher may use some other frame if this frame is in use
+	page_entry* frame_to_replace;
+
+	// the monotonic timestamp of the creation of this page_request, it helps us measure the time it waits to be dispatched
+	// it also breaks the ties between the page_requests of the same class and priority, the older page_request is fulfilled first
+	TIMESTAMP_ns creation_timestamp_ns;
+
 
 	// MAIN LOGIC FOR PAGE REQUEST JOB FULFILLMENT AND QUEUING PAGE_ID TO ALL THE WAITING USER THREADS
 
@@ -71,7 +102,8 @@ struct page_request
 
 // this function returns a new page_request, whose reference count is already 1
 // we assume that you are going to reference this page_request if you are creating it
-page_request* get_page_request(PAGE_ID page_id);
+// frame_to_replace may be NULL, (check the frame_to_replace attribute of the page_request)
+page_request* get_page_request(PAGE_ID page_id, page_request_class request_class, page_entry* frame_to_replace);
 
 // no mentioned earlier, no locks are being used here, it will only increment the page_request_priority
 // it will return 0, and not increment the page_request_priority, if the priority value was 0xff, 
@@ -103,6 +135,13 @@ int increment_page_request_priority(page_request* page_req);
 // else it will queue the page_id to the bbq and exit
 void insert_to_queue_of_waiting_bbqueues(page_request* page_req, bbqueue* bbq);
 
+// removes one occurrence of the bbq from the queue_of_waiting_bbqs, so that the page_id of this page_request will not be pushed to it
+// it returns 1, if the bbq was removed, it returns 0, if the bbq was not waiting (or if the page_id has already been pushed to it)
+int remove_from_queue_of_waiting_bbqueues(page_request* page_req, bbqueue* bbq);
+
+// returns 1, if there are any bbqs waiting for the fulfillment of this page_request
+int has_waiting_bbqueues(page_request* page_req);
+
 /* Below is the functions to be used by the io_dispatcher thread that is responsible for fulfillment of the page_request */
 
 // this function will set result for the fulfilment promise of the page_request
@@ -118,6 +157,11 @@ void fulfill_requested_page_entry_for_page_request(page_request* page_req, page_
 // DO NOT ATTEMPT TO USE THIS PAGE REQUEST OR SHARE IT AFTER THIS FUNCTION RETURNS YOU YOUR PAGE_ENTRY
 page_entry* get_requested_page_entry_and_discard_page_request(page_request* page_req);
 
+// non blocking call, it only gives up your reference to the page_request, without waiting for it to be fulfilled
+// it is to be used, when you only want the page to be brought to memory, but you do not want to wait for it (example read ahead)
+// the same rules as above apply, do not use the page_request after calling this function
+void release_page_request_reference(page_request* page_req);
+
 
 
 
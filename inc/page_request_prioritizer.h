@@ -23,6 +23,16 @@ struct page_request_prioritizer
 
 	// the request priority queue is used to help the buffer pool kow which request is more important to process first
 	heap page_request_priority_queue;
+
+	// if non zero, page_requests are dispatched in elevator (C-SCAN) order, of their page_ids (and hence of their block_ids on disk)
+	// among the page_requests of the same class as the highest priority page_request, whose priority is within elevator_priority_band of the highest priority
+	// a page_request that is older than the band, gets dispatched strictly by its priority, but the priorities saturate at 0xff (after 255 newer page_requests)
+	// so once the highest priority page_request is saturated, the elevator is bypassed and the saturated page_requests are dispatched oldest first (by their creation_timestamp_ns),
+	// this is what bounds the starvation, the elevator only reorders the page_requests that have waited for less than 255 newer page_requests
+	uint8_t elevator_priority_band;
+
+	// the page_id at which the elevator sweep resumes, the elevator only moves up the disk and then wraps around to the lowest page_id
+	PAGE_ID elevator_position;
 };
 
 page_request_prioritizer* get_page_request_prioritizer(PAGE_COUNT max_requests);
@@ -30,15 +40,24 @@ page_request_prioritizer* get_page_request_prioritizer(PAGE_COUNT max_requests);
 // creates a new page request
 // increments all the page request priority in the heap by 1
 // inserts the new page request to heap and queue to io_dispatcher that it needs to fulfill a page_request
-page_request* create_and_queue_page_request(page_request_prioritizer* prp_p, PAGE_ID page_id, bufferpool* buffp);
+// frame_to_replace is only a hint for the io_dispatcher, it can be NULL
+page_request* create_and_queue_page_request(page_request_prioritizer* prp_p, PAGE_ID page_id, page_request_class request_class, page_entry* frame_to_replace, bufferpool* buffp);
 
-// increments page request priority by 1
-void increment_priority_for_page_request(page_request_prioritizer* prp_p, page_request* pg_req);
+// increments page request priority by 1, and upgrades its request_class to the given request_class, if it is higher
+// it does nothing, if the page_request has already been dispatched
+void increment_priority_for_page_request(page_request_prioritizer* prp_p, page_request* pg_req, page_request_class request_class);
+
+// removes the page_request from the priority queue, only if it has not yet been dispatched to the io_dispatcher
+// returns 1, if the page_request was removed, the io job queued for this page_request, will then find some other page_request (or none) to fulfill
+int remove_page_request_if_not_dispatched(page_request_prioritizer* prp_p, page_request* pg_req);
 
 // the below function will query the priority queue (max heap) of the page_request tracker, and provide you with a page_request to fullfill
 // the io_dispatcher of the bufferpool is suppossed to fullfill the highest priority page_requests before others
 page_request* get_highest_priority_page_request_to_fulfill(page_request_prioritizer* prp_p);
 
+// sets the elevator_priority_band of the page_request_prioritizer, a band of 0 disables the elevator ordered dispatch
+void set_elevator_priority_band(page_request_prioritizer* prp_p, uint8_t elevator_priority_band);
+
 void delete_page_request_prioritizer(page_request_prioritizer* prp_p);
 
 #endif
\ No newline at end of file
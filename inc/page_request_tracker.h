@@ -35,7 +35,14 @@ page_request_tracker* get_page_request_tracker(PAGE_COUNT max_requests);
 // you must to wait on it by calling "get_requested_page_entry_and_discard_page_request" on the page_request
 // if you have provided with valid bbq, the page_id of the page will be pushed into the queue when the request is fulfilled
 // if while creating a new page request, if it is found that a page_entry corresponding to the request already exist then NULL will be returned and *existing_page_entry would be returned
-page_request* find_or_create_request_for_page_id(page_request_tracker* prt_p, PAGE_ID page_id, bufferpool* buffp, bbqueue* bbq, page_entry** existing_page_entry);
+// frame_to_replace is passed to the page_request, only if a new page_request gets created, it may be NULL
+// the request_class of an existing page_request is upgraded to the given request_class, if it is higher
+page_request* find_or_create_request_for_page_id(page_request_tracker* prt_p, PAGE_ID page_id, page_request_class request_class, bufferpool* buffp, bbqueue* bbq, page_entry* frame_to_replace, page_entry** existing_page_entry);
+
+// it removes the bbq from the bbqs waiting on the page_request of the given page_id, so the page_id will not be pushed to the bbq
+// if no one else is waiting on the page_request, and if its io has not been dispatched yet, then the page_request itself is discarded
+// returns 1, if the bbq was removed, it returns 0, if there was no such request or if the page_id has already been pushed to the bbq
+int cancel_page_request_for_bbqueue(page_request_tracker* prt_p, PAGE_ID page_id, bufferpool* buffp, bbqueue* bbq);
 
 // this function will discard a request from page_request_tracker, and mark the page_request for deletion, 
 // the function returns 1, if the page_request was successfully discarded and deleted
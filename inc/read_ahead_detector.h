@@ -0,0 +1,75 @@
+#ifndef READ_AHEAD_DETECTOR_H
+#define READ_AHEAD_DETECTOR_H
+
+#include<buffer_pool_man_types.h>
+
+#include<pthread.h>
+
+/*
+	The read_ahead_detector tracks a few streams of accesses to consecutive page_ids of the heap file
+
+	a stream is started on a page miss, and it is considered sequential once the next page_id of the stream is also missed
+	then the pages ahead of the stream are read ahead in windows, that grow (doubling) from initial_window to max_window pages
+	the first page of the last window read ahead is the trigger page of the stream, when it is accessed, the next window is read ahead
+	a stream whose pattern breaks is no longer matched by any access, it is then replaced by a new stream
+*/
+
+#define READ_AHEAD_STREAMS_COUNT 8
+
+#define INITIAL_READ_AHEAD_WINDOW 8
+
+#define MAX_READ_AHEAD_WINDOW 64
+
+typedef struct read_ahead_stream read_ahead_stream;
+struct read_ahead_stream
+{
+	// the page_id of the page, that the stream is expected to miss next
+	PAGE_ID next_expected_page_id;
+
+	// the pages of the stream before this page_id have been read ahead
+	PAGE_ID read_ahead_upto_page_id;
+
+	// the next window of the stream must be read ahead when this page is accessed,
+	// it is read without the lock on every page access, so it must be accessed atomically
+	PAGE_ID trigger_page_id;
+
+	// is set, if trigger_page_id is valid
+	int has_trigger;
+
+	// the number of consecutive pages missed by this stream
+	PAGE_COUNT sequential_count;
+
+	// the number of pages to be read ahead in the next window
+	PAGE_COUNT window;
+
+	// the value of the access_tick of the detector, when this stream was last accessed, it helps us replace the least recently used stream
+	uint64_t last_access_tick;
+};
+
+typedef struct read_ahead_detector read_ahead_detector;
+struct read_ahead_detector
+{
+	// protects all the streams
+	pthread_mutex_t read_ahead_lock;
+
+	// the maximum number of pages read ahead at once
+	PAGE_COUNT max_window;
+
+	uint64_t access_tick;
+
+	read_ahead_stream streams[READ_AHEAD_STREAMS_COUNT];
+};
+
+read_ahead_detector* get_read_ahead_detector(PAGE_COUNT max_window);
+
+// returns 1, if the page_id is the trigger page of any of the streams
+// it does not take any lock or write to the detector, so it can be called on every page hit
+int is_read_ahead_trigger(read_ahead_detector* rad_p, PAGE_ID page_id);
+
+// registers the access of a page (that was a miss, or a trigger page), and returns the number of pages to be read ahead
+// pages must be read ahead starting with *read_ahead_start_page_id, if the returned value is non zero
+PAGE_COUNT register_page_access_for_read_ahead(read_ahead_detector* rad_p, PAGE_ID page_id, int is_miss, PAGE_ID* read_ahead_start_page_id);
+
+void delete_read_ahead_detector(read_ahead_detector* rad_p);
+
+#endif
\ No newline at end of file
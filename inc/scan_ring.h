@@ -0,0 +1,77 @@
+#ifndef SCAN_RING_H
+#define SCAN_RING_H
+
+#include<buffer_pool_man_types.h>
+
+#include<pthread.h>
+
+#include<page_entry.h>
+
+/*
+	A scan_ring is a small bounded set of frames (page_entries), that is private to a sequential scan
+
+	until the ring is full, the pages missed by the scan are brought into frames taken from the lru (as usual),
+	and these frames are then adopted by the ring, instead of being returned to the lru on release
+	once the ring is full, every page missed by the scan is read into the oldest frame of the ring (recycling it)
+
+	this lets a large scan cycle through only ring_size frames of the bufferpool,
+	leaving the working set of the rest of the bufferpool untouched
+
+	a frame is owned by the ring, only while it holds the page that the ring read into it, and only while it is not in the lru
+	a page of the ring that is also used by some other thread (not through the ring), is returned to the lru on its release, and it becomes part of the working set
+	such a frame (or a frame that has been replaced since) is never recycled by the ring, it is dropped from the ring instead, and the next miss of the scan takes a frame from the lru
+*/
+
+typedef struct scan_ring_slot scan_ring_slot;
+struct scan_ring_slot
+{
+	page_entry* frame;
+
+	// the page that the ring read into the frame, the frame belongs to the ring only as long as it holds this page
+	PAGE_ID page_id;
+};
+
+typedef struct scan_ring scan_ring;
+struct scan_ring
+{
+	// protects all the attributes of the scan_ring
+	pthread_mutex_t scan_ring_lock;
+
+	// maximum number of frames, that this ring may hold
+	PAGE_COUNT ring_size;
+
+	// number of frames currently held by the ring
+	PAGE_COUNT frames_in_ring;
+
+	// index (in frames) of the frame that will be recycled next, once the ring is full
+	PAGE_COUNT next_frame_to_recycle;
+
+	// index (in frames) of the frame that was last given out to be recycled
+	// if it could not be recycled (because it was pinned by some other thread), the newly adopted frame takes its slot
+	PAGE_COUNT last_recycled_frame;
+
+	// the frames of this ring
+	scan_ring_slot slots[];
+};
+
+typedef struct bufferpool bufferpool;
+
+// returns the frame of the ring that the next missed page of the scan must be read into
+// it returns NULL, if the ring is not yet full, (i.e. the frame must be taken from the lru)
+// it also returns NULL, if the frame to be recycled is no longer owned by the ring (see above), that frame is then dropped from the ring
+page_entry* get_frame_to_recycle(bufferpool* buffp, scan_ring* ring);
+
+// returns 1, if the page_ent is one of the frames of the ring
+int is_frame_in_scan_ring(scan_ring* ring, page_entry* page_ent);
+
+// adds page_ent (holding the page that the scan just missed) to the frames of the ring,
+// if the ring is full, page_ent takes the slot of the frame that was last given out to be recycled, 
+// and that frame is returned, it must be returned back to the lru by the caller
+// it returns NULL, if no frame was dropped from the ring
+page_entry* adopt_frame_in_scan_ring(scan_ring* ring, page_entry* page_ent);
+
+// a frame dropped from the ring is put back in circulation, (in the lru as an evictable page_entry)
+// only if it is not pinned and not already in the lru
+void return_frame_to_lru(bufferpool* buffp, page_entry* page_ent);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,79 @@
+#ifndef SHARED_SCAN_COORDINATOR_H
+#define SHARED_SCAN_COORDINATOR_H
+
+#include<buffer_pool_man_types.h>
+
+#include<pthread.h>
+
+#include<linkedlist.h>
+
+#include<bounded_blocking_queue.h>
+
+/*
+	The shared_scan_coordinator lets concurrent sequential scans over the same range of pages share their disk io
+
+	all the shared_scans over the same range of pages form a scan_group
+	the scan_group has a cursor, that moves (wrapping around) over the range of the pages,
+	each page that the cursor passes over is prefetched once, for all the shared_scans of the group that have not yet received that page
+
+	a shared_scan joining a running scan_group, starts receiving pages at the current position of the cursor,
+	and it receives the pages it missed (the ones before its joining position), once the cursor wraps around
+	hence N concurrent full scans over a range, cost about one pass of disk io, instead of N
+*/
+
+typedef struct scan_group scan_group;
+struct scan_group
+{
+	// the range of pages that the scan_group scans
+	PAGE_ID start_page_id;
+	PAGE_COUNT page_count;
+
+	// offset (from the start_page_id) of the page that the cursor of the scan_group will prefetch next
+	PAGE_COUNT next_page_offset;
+
+	// all the shared_scans of this scan_group
+	linkedlist shared_scans;
+
+	// node of the scan_groups linkedlist of the shared_scan_coordinator
+	llnode scan_groups_ll_node;
+};
+
+typedef struct shared_scan shared_scan;
+struct shared_scan
+{
+	// the group that this shared_scan belongs to
+	scan_group* group;
+
+	// the pages loaded for this shared_scan are pushed to this bbq, it can hold window_size page_ids
+	bbqueue* bbq;
+
+	// the maximum number of pages, that may have been requested for this scan, but not yet consumed
+	PAGE_COUNT window_size;
+
+	// the pages requested for this scan (pushed/to be pushed to its bbq) and the pages consumed (popped from its bbq)
+	PAGE_COUNT pages_requested;
+	PAGE_COUNT pages_consumed;
+
+	// a bit for every page of the range of the group, the bit is set once the page is requested for this scan
+	uint8_t* pages_requested_bitmap;
+
+	// node of the shared_scans linkedlist of the scan_group
+	llnode shared_scans_ll_node;
+};
+
+typedef struct shared_scan_coordinator shared_scan_coordinator;
+struct shared_scan_coordinator
+{
+	// protects all the scan_groups and all their shared_scans
+	// it is never held while waiting on a bbq
+	pthread_mutex_t coordinator_lock;
+
+	// all the scan_groups that have atleast one shared_scan
+	linkedlist scan_groups;
+};
+
+shared_scan_coordinator* get_shared_scan_coordinator();
+
+void delete_shared_scan_coordinator(shared_scan_coordinator* ssc_p);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,52 @@
+#ifndef STATS_SHARDS_H
+#define STATS_SHARDS_H
+
+#include<bufferpool.h>
+
+/*
+	The statistics counters and the latency histograms of the bufferpool are sharded, each thread increments the counters only in its own shard
+	each shard is aligned to (and padded upto) a cache line, so threads incrementing their counters never write to the same cache line
+	this keeps the page hit path free of any shared writes
+
+	the shards are assigned to the threads in round robin order, when a thread increments a counter for the first time
+	a shard is shared by threads only if there are more than STATS_SHARDS_COUNT threads, this is why the counters are incremented atomically
+	get_bufferpool_stats() sums up the counters of all the shards, and get_bufferpool_latency_histogram() merges the histograms of all the shards
+*/
+
+#define STATS_SHARDS_COUNT 32
+
+typedef struct stats_shard stats_shard;
+struct stats_shard
+{
+	bufferpool_stats counters;
+
+	latency_histogram latencies[BUFFERPOOL_LATENCIES_COUNT];
+} __attribute__((aligned(CACHE_LINE_SIZE)));
+
+typedef struct stats_shards stats_shards;
+struct stats_shards
+{
+	stats_shard shards[STATS_SHARDS_COUNT];
+};
+
+stats_shards* get_stats_shards();
+
+// returns the shard of the calling thread
+stats_shard* get_stats_shard_for_this_thread(stats_shards* ss_p);
+
+// sums up the counters of all the shards into stats
+void aggregate_stats_shards(stats_shards* ss_p, bufferpool_stats* stats);
+
+// merges the given latency histograms of all the shards into hist
+void aggregate_latency_histograms_of_stats_shards(stats_shards* ss_p, bufferpool_latency latency, latency_histogram* hist);
+
+void delete_stats_shards(stats_shards* ss_p);
+
+// increments (or adds to) a counter of bufferpool_stats, in the shard of the calling thread
+#define add_to_stat(ss_p, counter, value)	__atomic_fetch_add(&(get_stats_shard_for_this_thread(ss_p)->counters.counter), (value), __ATOMIC_RELAXED)
+#define increment_stat(ss_p, counter)		add_to_stat(ss_p, counter, 1)
+
+// records the time elapsed since start_timestamp (a monotonic timestamp in nanoseconds), in the latency histogram of the calling thread's shard
+#define record_latency_since(ss_p, latency, start_timestamp)	{TIMESTAMP_ns end_timestamp;setToCurrentMonotonicTimestamp_ns(end_timestamp);record_in_latency_histogram(&(get_stats_shard_for_this_thread(ss_p)->latencies[(latency)]), end_timestamp - (start_timestamp));}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,53 @@
+#ifndef WARM_RESTART_H
+#define WARM_RESTART_H
+
+#include<buffer_pool_man_types.h>
+
+/*
+	A resident pages dump file lists the pages that were in the bufferpool, so that a restarted bufferpool can be warmed up with them
+
+	it is a header, followed by one entry per page, the entries are in the order of recency of the pages,
+	the first entry is the page that would have been evicted first, and the last entry is the most recently used page
+	(the pages that were pinned or were never used after being brought to memory, are listed last)
+*/
+
+#define RESIDENT_PAGES_DUMP_MAGIC 0x42505244
+
+#define RESIDENT_PAGES_DUMP_VERSION 1
+
+typedef struct resident_pages_dump_header resident_pages_dump_header;
+struct resident_pages_dump_header
+{
+	uint32_t magic;
+	uint32_t version;
+
+	// the page size of the bufferpool, the dump can only be loaded in to a bufferpool with the same page_size
+	uint32_t page_size;
+
+	// the number of entries following the header
+	uint32_t entries_count;
+};
+
+typedef struct resident_page_entry resident_page_entry;
+struct resident_page_entry
+{
+	PAGE_ID page_id;
+
+	// the usage_count of the page_entry, restored on warm up
+	uint32_t usage_count;
+};
+
+// the number of pages, that are read from disk with a single read, while warming up the bufferpool
+// the runs of consecutive page_ids in the dump are read together, upto these many pages
+#define MAX_PAGES_PER_WARM_UP_READ 64
+
+typedef struct bufferpool bufferpool;
+
+// writes the resident pages of the bufferpool to the dump file, returns 0 on failure
+int write_resident_pages_dump(bufferpool* buffp, char* dump_file_name);
+
+// reads the pages of the dump file, in to the free frames of the bufferpool, in the order of their page_ids (i.e. of their start_block_ids) with large sequential reads
+// and then puts them in the lru in the order of their recency, returns the number of pages brought to memory
+PAGE_COUNT load_resident_pages_dump(bufferpool* buffp, char* dump_file_name);
+
+#endif
\ No newline at end of file
@@ -1,117 +1,252 @@
 #include<bounded_blocking_queue.h>
 
-#include<pthread.h>
+#include<limits.h>
+#include<unistd.h>
+#include<sys/syscall.h>
+#include<linux/futex.h>
+
+// the number of times a thread retries, before it goes to sleep on the futex, waiting for the queue to be not full/not empty
+#define SPINS_BEFORE_SLEEP 64
+
+// the two positions and the futex words are kept on separate cache lines (of CACHE_LINE_SIZE), so that the producers and the consumers do not write to the same cache line
+
+typedef struct bbqueue_slot bbqueue_slot;
+struct bbqueue_slot
+{
+	// a producer can write this slot when sequence == its push position
+	// a consumer can read this slot when sequence == its pop position + 1
+	uint64_t sequence;
+
+	PAGE_ID page_id;
+};
+
+// a futex word, that is incremented every time the waited upon condition may have changed, along with the count of its sleeping waiters
+typedef struct bbqueue_event bbqueue_event;
+struct bbqueue_event
+{
+	uint32_t futex_word;
+
+	uint32_t waiters_count;
+};
 
 struct bbqueue
 {
-	// to protect exclusive access to critical section
-	pthread_mutex_t exclus_prot;
-	
-	// wait on this is queue is full
-	pthread_cond_t full_wait;
+	// total size of queue array
+	uint32_t queue_size;
 
-	// wait on this if queue is empty
-	pthread_cond_t empty_wait;
+	char padding0[CACHE_LINE_SIZE - sizeof(uint32_t)];
 
-	// index where oldest element was inserted
-	uint16_t first_index;
+	// the position at which the next element will be pushed, only ever increments
+	uint64_t push_position;
 
-	// index where the last newest element was inserted
-	uint16_t last_index;
+	char padding1[CACHE_LINE_SIZE - sizeof(uint64_t)];
 
-	// total number of elements in the queue
-	uint16_t element_count;
+	// the position from which the next element will be popped, only ever increments
+	uint64_t pop_position;
 
-	// total size of queue array
-	uint16_t queue_size;
+	char padding2[CACHE_LINE_SIZE - sizeof(uint64_t)];
+
+	// producers sleep on this, while the queue is full
+	bbqueue_event not_full;
+
+	char padding3[CACHE_LINE_SIZE - sizeof(bbqueue_event)];
+
+	// consumers sleep on this, while the queue is empty
+	bbqueue_event not_empty;
+
+	char padding4[CACHE_LINE_SIZE - sizeof(bbqueue_event)];
 
-	// queue array
-	PAGE_ID queue_values[];
+	// queue array, the element at position p is in the slot p % queue_size
+	bbqueue_slot queue_slots[];
 };
 
-bbqueue* get_bbqueue(uint16_t size)
+bbqueue* get_bbqueue(uint32_t size)
 {
-	bbqueue* bbq = (bbqueue*) malloc(sizeof(bbqueue) + (sizeof(PAGE_ID) * size));
+	// a queue of size 0, would block all its users forever
+	if(size == 0)
+		size = 1;
 
-	pthread_mutex_init(&(bbq->exclus_prot), NULL);
-	pthread_cond_init(&(bbq->full_wait), NULL);
-	pthread_cond_init(&(bbq->empty_wait), NULL);
+	bbqueue* bbq = (bbqueue*) malloc(sizeof(bbqueue) + (sizeof(bbqueue_slot) * size));
 
 	bbq->queue_size = size;
 
-	bbq->element_count = 0;
+	bbq->push_position = 0;
+	bbq->pop_position = 0;
 
-	bbq->first_index = 2;
-	bbq->last_index = 1;
+	bbq->not_full = (bbqueue_event){};
+	bbq->not_empty = (bbqueue_event){};
+
+	for(uint32_t i = 0; i < size; i++)
+		bbq->queue_slots[i].sequence = i;
 
 	return bbq;
 }
 
 int is_bbqueue_empty(bbqueue* bbq)
 {
-	pthread_mutex_lock(&(bbq->exclus_prot));
-		int is_empty = (bbq->element_count == 0);
-	pthread_mutex_unlock(&(bbq->exclus_prot));
-	return is_empty;
+	uint64_t pop_position = __atomic_load_n(&(bbq->pop_position), __ATOMIC_SEQ_CST);
+	uint64_t push_position = __atomic_load_n(&(bbq->push_position), __ATOMIC_SEQ_CST);
+	return push_position <= pop_position;
 }
 
 int is_bbqueue_full(bbqueue* bbq)
 {
-	pthread_mutex_lock(&(bbq->exclus_prot));
-		int is_full = (bbq->element_count == bbq->queue_size);
-	pthread_mutex_unlock(&(bbq->exclus_prot));
-	return is_full;
+	uint64_t pop_position = __atomic_load_n(&(bbq->pop_position), __ATOMIC_SEQ_CST);
+	uint64_t push_position = __atomic_load_n(&(bbq->push_position), __ATOMIC_SEQ_CST);
+	return push_position >= pop_position + bbq->queue_size;
 }
 
-void push_bbqueue(bbqueue* bbq, PAGE_ID page_id)
+static void wake_up_waiters(bbqueue_event* event)
+{
+	// the increment must be ordered before the read of the waiters_count, (sequentially consistent with the waiter's increment of waiters_count and its read of the futex_word)
+	__atomic_add_fetch(&(event->futex_word), 1, __ATOMIC_SEQ_CST);
+	if(__atomic_load_n(&(event->waiters_count), __ATOMIC_SEQ_CST) > 0)
+		syscall(SYS_futex, &(event->futex_word), FUTEX_WAKE_PRIVATE, INT_MAX, NULL, NULL, 0);
+}
+
+// returns 1, if the page_id was pushed, else 0 if the queue was full
+static int try_push_bbqueue(bbqueue* bbq, PAGE_ID page_id)
 {
-	pthread_mutex_lock(&(bbq->exclus_prot));
+	uint64_t position = __atomic_load_n(&(bbq->push_position), __ATOMIC_RELAXED);
+	while(1)
+	{
+		bbqueue_slot* slot = bbq->queue_slots + (position % bbq->queue_size);
+		uint64_t sequence = __atomic_load_n(&(slot->sequence), __ATOMIC_ACQUIRE);
+		int64_t diff = (int64_t)(sequence - position);
+
+		// the slot is free for this position, claim the position
+		if(diff == 0)
+		{
+			if(__atomic_compare_exchange_n(&(bbq->push_position), &position, position + 1, 1, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED))
+			{
+				slot->page_id = page_id;
+				__atomic_store_n(&(slot->sequence), position + 1, __ATOMIC_RELEASE);
+				return 1;
+			}
+			// else the failed compare exchange has reloaded the position
+		}
+		// the slot still holds the element from queue_size positions ago, that is not yet popped, so the queue is full
+		else if(diff < 0)
+			return 0;
+		// some other producer claimed this position, retry with the latest one
+		else
+			position = __atomic_load_n(&(bbq->push_position), __ATOMIC_RELAXED);
+	}
+}
 
-		// wait while queue is full
-		while(bbq->element_count == bbq->queue_size)
+// returns 1, if a page_id was popped in to page_id, else 0 if the queue was empty
+static int try_pop_bbqueue(bbqueue* bbq, PAGE_ID* page_id)
+{
+	uint64_t position = __atomic_load_n(&(bbq->pop_position), __ATOMIC_RELAXED);
+	while(1)
+	{
+		bbqueue_slot* slot = bbq->queue_slots + (position % bbq->queue_size);
+		uint64_t sequence = __atomic_load_n(&(slot->sequence), __ATOMIC_ACQUIRE);
+		int64_t diff = (int64_t)(sequence - (position + 1));
+
+		// the slot holds the element for this position, claim the position
+		if(diff == 0)
 		{
-			pthread_cond_wait(&(bbq->full_wait), &(bbq->exclus_prot));
+			if(__atomic_compare_exchange_n(&(bbq->pop_position), &position, position + 1, 1, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED))
+			{
+				(*page_id) = slot->page_id;
+				// make the slot available to the producer, that would push at position + queue_size
+				__atomic_store_n(&(slot->sequence), position + bbq->queue_size, __ATOMIC_RELEASE);
+				return 1;
+			}
 		}
+		// the element for this position is not yet pushed (or not yet completely written), so the queue is empty
+		else if(diff < 0)
+			return 0;
+		else
+			position = __atomic_load_n(&(bbq->pop_position), __ATOMIC_RELAXED);
+	}
+}
 
-		// push element
-		bbq->last_index = ((bbq->last_index + 1) % bbq->queue_size);
-		bbq->queue_values[bbq->last_index] = page_id;
-		bbq->element_count++;
+// spins and then sleeps, until is_ready returns 1
+// the futex_word is read before the retry, so a wake up between the retry and the FUTEX_WAIT makes the FUTEX_WAIT return immediately
+#define wait_until(event, is_ready)																		\
+{																										\
+	int spins = 0;																						\
+	while(!(is_ready))																					\
+	{																									\
+		if(spins++ < SPINS_BEFORE_SLEEP)																\
+			continue;																					\
+		__atomic_add_fetch(&((event)->waiters_count), 1, __ATOMIC_SEQ_CST);								\
+		uint32_t futex_word = __atomic_load_n(&((event)->futex_word), __ATOMIC_SEQ_CST);				\
+		if(is_ready)																					\
+		{																								\
+			__atomic_sub_fetch(&((event)->waiters_count), 1, __ATOMIC_SEQ_CST);							\
+			break;																						\
+		}																								\
+		syscall(SYS_futex, &((event)->futex_word), FUTEX_WAIT_PRIVATE, futex_word, NULL, NULL, 0);		\
+		__atomic_sub_fetch(&((event)->waiters_count), 1, __ATOMIC_SEQ_CST);								\
+	}																									\
+}
 
-		// wake up any thread waiting on empty conditional wait
-		pthread_cond_signal(&(bbq->empty_wait));
+void push_bbqueue(bbqueue* bbq, PAGE_ID page_id)
+{
+	wait_until(&(bbq->not_full), try_push_bbqueue(bbq, page_id));
 
-	pthread_mutex_unlock(&(bbq->exclus_prot));
+	// wake up any thread waiting on the queue to be not empty
+	wake_up_waiters(&(bbq->not_empty));
 }
 
 PAGE_ID pop_bbqueue(bbqueue* bbq)
 {
-	pthread_mutex_lock(&(bbq->exclus_prot));
+	PAGE_ID page_id;
+	wait_until(&(bbq->not_empty), try_pop_bbqueue(bbq, &page_id));
+
+	// wake up any thread waiting on the queue to be not full
+	wake_up_waiters(&(bbq->not_full));
 
-		// wait while queue is empty
-		while(bbq->element_count == 0)
+	return page_id;
+}
+
+void push_bbqueue_batch(bbqueue* bbq, const PAGE_ID* page_ids, uint32_t page_ids_count)
+{
+	uint32_t pushed_count = 0;
+	while(pushed_count < page_ids_count)
+	{
+		// push as many as there is space for, without waiting
+		uint32_t pushed_now = 0;
+		while(pushed_count < page_ids_count && try_push_bbqueue(bbq, page_ids[pushed_count]))
+		{
+			pushed_count++;
+			pushed_now++;
+		}
+
+		// the consumers must get what is already pushed, before we wait for them to make space
+		if(pushed_now > 0)
+			wake_up_waiters(&(bbq->not_empty));
+
+		if(pushed_count < page_ids_count)
 		{
-			pthread_cond_wait(&(bbq->empty_wait), &(bbq->exclus_prot));
+			wait_until(&(bbq->not_full), try_push_bbqueue(bbq, page_ids[pushed_count]));
+			pushed_count++;
+			wake_up_waiters(&(bbq->not_empty));
 		}
+	}
+}
 
-		// pop element
-		PAGE_ID page_id = bbq->queue_values[bbq->first_index];
-		bbq->first_index = ((bbq->first_index + 1) % bbq->queue_size);
-		bbq->element_count--;
+uint32_t pop_bbqueue_batch(bbqueue* bbq, PAGE_ID* page_ids, uint32_t max_page_ids_count)
+{
+	if(max_page_ids_count == 0)
+		return 0;
 
-		// wake up any thread waiting on empty conditional wait
-		pthread_cond_signal(&(bbq->full_wait));
+	// wait for the first one, and then take the rest that are already in the queue
+	wait_until(&(bbq->not_empty), try_pop_bbqueue(bbq, page_ids));
+	uint32_t popped_count = 1;
+	while(popped_count < max_page_ids_count && try_pop_bbqueue(bbq, page_ids + popped_count))
+		popped_count++;
 
-	pthread_mutex_unlock(&(bbq->exclus_prot));
+	// wake up any thread waiting on the queue to be not full
+	wake_up_waiters(&(bbq->not_full));
 
-	return page_id;
+	return popped_count;
 }
 
 void delete_bbqueue(bbqueue* bbq)
 {
-	pthread_mutex_destroy(&(bbq->exclus_prot));
-	pthread_cond_destroy(&(bbq->full_wait));
-	pthread_cond_destroy(&(bbq->empty_wait));
-
 	free(bbq);
 }
\ No newline at end of file
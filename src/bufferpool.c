@@ -3,10 +3,15 @@
 #include<bufferpool_struct_def.h>
 
 #include<cleanup_scheduler.h>
+#include<warm_restart.h>
+#include<numa_placement.h>
 
 #include<sys/mman.h>
 
-bufferpool* get_bufferpool(char* heap_file_name, PAGE_COUNT pages_in_bufferpool, SIZE_IN_BYTES page_size, uint8_t io_thread_count, TIME_ms cleanup_rate_in_milliseconds, TIME_ms unused_prefetched_page_return_in_ms)
+#include<assert.h>
+#include<sched.h>
+
+bufferpool* get_bufferpool(char* heap_file_name, PAGE_COUNT pages_in_bufferpool, SIZE_IN_BYTES page_size, uint8_t read_io_thread_count, uint8_t write_io_thread_count, TIME_ms cleanup_rate_in_milliseconds, TIME_ms unused_prefetched_page_return_in_ms)
 {
 	if(pages_in_bufferpool == 0)
 	{
@@ -18,9 +23,9 @@ bufferpool* get_bufferpool(char* heap_file_name, PAGE_COUNT pages_in_bufferpool,
 		printf("The pagesize of the buffer pool must be a multiple of hardware block size and not 0, hence buffer pool can not be built\n");
 		return NULL;
 	}
-	if(io_thread_count == 0)
+	if(read_io_thread_count == 0 || write_io_thread_count == 0)
 	{
-		printf("You must allow atleast 1 io_thread for the functioning of the bufferpool, hence buffer pool can not be built\n");
+		printf("You must allow atleast 1 read io_thread and 1 write io_thread for the functioning of the bufferpool, hence buffer pool can not be built\n");
 		return NULL;
 	}
 	if(cleanup_rate_in_milliseconds == 0)
@@ -69,9 +74,24 @@ bufferpool* get_bufferpool(char* heap_file_name, PAGE_COUNT pages_in_bufferpool,
 	buffp->lru_p = get_lru();
 	buffp->rq_tracker = get_page_request_tracker(pages_in_bufferpool);
 	buffp->rq_prioritizer = get_page_request_prioritizer(pages_in_bufferpool);
+	buffp->scan_coordinator = get_shared_scan_coordinator();
+	buffp->stats = get_stats_shards();
+	buffp->tracer = NULL;
+	buffp->tracer_users = 0;
+
+	// read ahead must not be allowed to occupy a considerable part of the bufferpool
+	PAGE_COUNT max_read_ahead_window = pages_in_bufferpool / 4;
+	if(max_read_ahead_window > MAX_READ_AHEAD_WINDOW)
+		max_read_ahead_window = MAX_READ_AHEAD_WINDOW;
+	buffp->ra_detector = (max_read_ahead_window > 0) ? get_read_ahead_detector(max_read_ahead_window) : NULL;
+
+	buffp->dirty_throttle = get_dirty_page_throttle();
+
+	buffp->resident_pages_dump_file_name = NULL;
 
 	// initialize empty page entries, and page_memory
-	buffp->page_entries = malloc(pages_in_bufferpool * sizeof(page_entry));
+	// the page_entries must be cache line aligned, as they are padded to never share a cache line (see page_entry.h)
+	buffp->page_entries = aligned_alloc(CACHE_LINE_SIZE, pages_in_bufferpool * sizeof(page_entry));
 	buffp->page_memories =  mmap(NULL, pages_in_bufferpool * page_size, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE | MAP_POPULATE, -1, 0);
 
 	for(PAGE_COUNT i = 0; i < pages_in_bufferpool; i++)
@@ -86,13 +106,63 @@ bufferpool* get_bufferpool(char* heap_file_name, PAGE_COUNT pages_in_bufferpool,
 	buffp->SHUTDOWN_CALLED = 0;
 
 	// start necessary threads/jobs
-	buffp->io_dispatcher = get_executor(FIXED_THREAD_COUNT_EXECUTOR, io_thread_count, 0, NULL, NULL, NULL);
+	buffp->read_io_dispatcher = get_executor(FIXED_THREAD_COUNT_EXECUTOR, read_io_thread_count, 0, NULL, NULL, NULL);
+	buffp->write_io_dispatcher = get_executor(FIXED_THREAD_COUNT_EXECUTOR, write_io_thread_count, 0, NULL, NULL, NULL);
+
+	buffp->shadow_copy_writeback = 0;
+	buffp->page_checksums = 0;
+	buffp->extent_map = NULL;
+	buffp->compressed_cache = get_compressed_page_cache();
+	buffp->l2_cache = NULL;
+	buffp->hole_map = NULL;
+	buffp->reserved_upto_page_id = 0;
+	pthread_mutex_init(&(buffp->reservation_lock), NULL);
+	buffp->writeback_staging_memories = mmap(NULL, write_io_thread_count * page_size, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE, -1, 0);
+	buffp->write_io_thread_count = write_io_thread_count;
+	buffp->writeback_staging_memories_claimed = 0;
 	start_async_cleanup_scheduler(buffp);
 
 	return buffp;
 }
 
-static page_entry* fetch_page_entry(bufferpool* buffp, PAGE_ID page_id)
+// requests the pages, that are not in memory, to be brought to memory, without waiting for them
+static void read_ahead_pages(bufferpool* buffp, PAGE_ID start_page_id, PAGE_COUNT page_count)
+{
+	// the pages past the end of the heap file (and its holes) hold only zeros, reading them ahead would only take frames away from the pages in use
+	// a page written after we look at the file size is only missed by this window, and the pages that are not yet written to the file are resident anyway
+	BLOCK_COUNT heap_file_block_count;
+	if(get_current_block_count(buffp->db_file, &heap_file_block_count) == 0)
+	{
+		PAGE_ID heap_file_end_page_id = (heap_file_block_count + buffp->number_of_blocks_per_page - 1) / buffp->number_of_blocks_per_page;
+		if(start_page_id >= heap_file_end_page_id)
+			return;
+		if(page_count > heap_file_end_page_id - start_page_id)
+			page_count = heap_file_end_page_id - start_page_id;
+	}
+
+	PAGE_ID page_id = start_page_id;
+	for(PAGE_COUNT i = 0; i < page_count; i++)
+	{
+		if(find_page_entry_by_page_id(buffp->pg_tbl, page_id) == NULL && (buffp->hole_map == NULL || !is_page_hole(buffp->hole_map, page_id)))
+		{
+			page_request* page_req = find_or_create_request_for_page_id(buffp->rq_tracker, page_id, READ_AHEAD_REQUEST, buffp, NULL, NULL, NULL);
+
+			// we do not wait for the read ahead page, so we give up our reference to the page_request immediately
+			if(page_req != NULL)
+			{
+				release_page_request_reference(page_req);
+				increment_stat(buffp->stats, pages_read_ahead);
+				trace_page_access(buffp, READ_AHEAD_EVENT, page_id, NO_LATCH, 0, 0);
+			}
+		}
+		page_id++;
+	}
+}
+
+// fetches and pins the page_entry for the given page_id
+// if a scan_ring is provided, the page (if missed) is preferrably read into a frame of the ring, that is to be recycled
+// *is_miss is set, if the calling thread had to wait for the page to be brought to memory
+static page_entry* fetch_page_entry(bufferpool* buffp, PAGE_ID page_id, scan_ring* ring, int* is_miss)
 {
 	int is_page_entry_found = 0;
 
@@ -124,15 +194,19 @@ static page_entry* fetch_page_entry(bufferpool* buffp, PAGE_ID page_id)
 
 		if(!is_page_entry_found)
 		{
+			// a scan must recycle the frames of its own ring, once its ring is full
+			page_entry* frame_to_replace = (ring != NULL) ? get_frame_to_recycle(buffp, ring) : NULL;
+
 			// search the request mapper hashmap, to get an already created page request, if not, create one for this page_id
 			// we do not provide any bbq, since we will immediately wait for getting page_entry from the page_request
-			page_request* page_req = find_or_create_request_for_page_id(buffp->rq_tracker, page_id, buffp, NULL, &page_ent);
+			page_request* page_req = find_or_create_request_for_page_id(buffp->rq_tracker, page_id, DEMAND_REQUEST, buffp, NULL, frame_to_replace, &page_ent);
 
 			if(page_req != NULL)
 			{
 				// we block until the page_request io is fullfilled, by the io dispatcher
 				// also it is not safe to reference the same page_request, once this method is called (check page_request.h)
 				page_ent = get_requested_page_entry_and_discard_page_request(page_req);
+				*is_miss = 1;
 			}
 
 			if(page_ent != NULL)
@@ -160,129 +234,393 @@ static page_entry* fetch_page_entry(bufferpool* buffp, PAGE_ID page_id)
 	// 1. pin it (incrementing the pinned by counter)
 	// 2. mark that it has been used (incrementing the usage counter)
 	// 3. remove the page from the LRU to avoid this page from being victimized for replacement
+	//    a pinned page_entry is never in the LRU (it is put in the LRU only once unpinned, under the page_entry_lock), so only the first pin has to take the lru_lock
 	if(is_page_entry_found)
 	{
 		page_ent->pinned_by_count++;
 
 		page_ent->usage_count++;
 
-		remove_page_entry_from_lru(buffp->lru_p, page_ent);
+		if(page_ent->pinned_by_count == 1)
+			remove_page_entry_from_lru(buffp->lru_p, page_ent);
 
 		pthread_mutex_unlock(&(page_ent->page_entry_lock));
+
+		// this write is to the stats shard of this thread, so the hit path stays free of shared writes
+		if(*is_miss)
+			increment_stat(buffp->stats, page_misses);
+		else
+			increment_stat(buffp->stats, page_hits);
 	}
 
+	// scans with a scan_ring are not read ahead, since the read ahead pages would not be read into the frames of its ring
+	// a page hit is registered with the read_ahead_detector, only if it is a trigger page, this keeps the page hit path free of any locks of the read_ahead_detector
+	if(buffp->ra_detector != NULL && ring == NULL && ((*is_miss) || is_read_ahead_trigger(buffp->ra_detector, page_id)))
+	{
+		PAGE_ID read_ahead_start_page_id;
+		PAGE_COUNT read_ahead_page_count = register_page_access_for_read_ahead(buffp->ra_detector, page_id, *is_miss, &read_ahead_start_page_id);
+		if(read_ahead_page_count > 0)
+			read_ahead_pages(buffp, read_ahead_start_page_id, read_ahead_page_count);
+	}
+
+	return page_ent;
+}
+
+// builds a page_handle for a page_entry that has been fetched (pinned) by the calling thread and latched in the given latch_mode
+static page_handle get_page_handle(bufferpool* buffp, page_entry* page_ent, page_latch_mode latch_mode)
+{
+	return (page_handle){
+		.page_memory = page_ent->page_memory,
+		.page_id = page_ent->page_id,
+		.frame_index = page_ent - buffp->page_entries,
+		.latch_mode = latch_mode,
+	};
+}
+
+// returns the page_entry held by the page_handle, the page_entry is pinned by the holder of the handle so it is directly accessible
+// it returns NULL, if the page_handle is not a valid handle of a latched page of this bufferpool
+static page_entry* get_page_entry_for_page_handle(bufferpool* buffp, page_handle* pg_handle)
+{
+	// a misused page_handle is a bug in the calling code, it is caught here in the debug builds
+	assert(pg_handle != NULL && pg_handle->latch_mode != NO_LATCH && pg_handle->frame_index < buffp->pages_in_bufferpool);
+
+	if(pg_handle == NULL || pg_handle->latch_mode == NO_LATCH || pg_handle->frame_index >= buffp->pages_in_bufferpool)
+		return NULL;
+
+	page_entry* page_ent = buffp->page_entries + pg_handle->frame_index;
+
+	// since the page is pinned by the holder of the handle, its page_id can not change
+	assert(page_ent->page_id == pg_handle->page_id && page_ent->page_memory == pg_handle->page_memory);
+
 	return page_ent;
 }
 
-void* acquire_page_with_reader_lock(bufferpool* buffp, PAGE_ID page_id)
+page_handle acquire_page_with_reader_lock(bufferpool* buffp, PAGE_ID page_id)
 {
-	page_entry* page_ent = fetch_page_entry(buffp, page_id);
+	TIMESTAMP_ns start_timestamp;
+	setToCurrentMonotonicTimestamp_ns(start_timestamp);
+
+	int is_miss = 0;
+	page_entry* page_ent = fetch_page_entry(buffp, page_id, NULL, &is_miss);
 
 	acquire_read_lock(page_ent);
 
-	return page_ent->page_memory;
+	record_latency_since(buffp->stats, ACQUIRE_PAGE_LATENCY, start_timestamp);
+	trace_page_access(buffp, ACQUIRE_EVENT, page_id, READER_LATCH, is_miss, 0);
+
+	return get_page_handle(buffp, page_ent, READER_LATCH);
 }
 
-void* acquire_page_with_writer_lock(bufferpool* buffp, PAGE_ID page_id)
+page_handle acquire_page_with_writer_lock(bufferpool* buffp, PAGE_ID page_id)
 {
-	page_entry* page_ent = fetch_page_entry(buffp, page_id);
+	TIMESTAMP_ns start_timestamp;
+	setToCurrentMonotonicTimestamp_ns(start_timestamp);
+
+	// pace the writer, if there are too many dirty pages
+	if(balance_dirty_pages(buffp))
+		increment_stat(buffp->stats, writers_throttled);
+
+	int is_miss = 0;
+	page_entry* page_ent = fetch_page_entry(buffp, page_id, NULL, &is_miss);
 
 	acquire_write_lock(page_ent);
 
-	return page_ent->page_memory;
+	record_latency_since(buffp->stats, ACQUIRE_PAGE_LATENCY, start_timestamp);
+	trace_page_access(buffp, ACQUIRE_EVENT, page_id, WRITER_LATCH, is_miss, 0);
+
+	return get_page_handle(buffp, page_ent, WRITER_LATCH);
 }
 
-int downgrade_page_lock_from_writer_to_reader(bufferpool* buffp, void* page_memory)
+int downgrade_page_lock_from_writer_to_reader(bufferpool* buffp, page_handle* pg_handle)
 {
-	page_entry* page_ent = find_page_entry_by_page_memory(buffp->pg_tbl, page_memory);
+	page_entry* page_ent = get_page_entry_for_page_handle(buffp, pg_handle);
 
-	// the function fails, if no such page_ent exists OR
-	// if no one is holding the writer lock on the page
-	if(page_ent == NULL || get_writers_count(&(page_ent->page_memory_lock)) == 0)
+	// the function fails, if the handle is invalid OR
+	// if the handle is not holding the writer lock on the page
+	if(page_ent == NULL || pg_handle->latch_mode != WRITER_LATCH)
 		return 0;
 
 	pthread_mutex_lock(&(page_ent->page_entry_lock));
 		// as the page was held with a writer lock prior to this call
 		// the page is now dirty as well as holding valid data values
-		set(page_ent, IS_DIRTY);
+		set_page_entry_dirty(buffp->dirty_throttle, page_ent);
 		set(page_ent, IS_VALID);
 	pthread_mutex_unlock(&(page_ent->page_entry_lock));
 
 	downgrade_write_lock_to_read_lock(page_ent);
 
+	pg_handle->latch_mode = READER_LATCH;
+
+	return 1;
+}
+
+int mark_page_as_dirty(bufferpool* buffp, page_handle* pg_handle)
+{
+	// a page that is only read locked may be read by others at the same time, it must never be modified (and hence dirtied)
+	if(pg_handle == NULL || pg_handle->latch_mode != WRITER_LATCH)
+		return 0;
+
+	page_entry* page_ent = get_page_entry_for_page_handle(buffp, pg_handle);
+
+	if(page_ent == NULL)
+		return 0;
+
+	pthread_mutex_lock(&(page_ent->page_entry_lock));
+		set_page_entry_dirty(buffp->dirty_throttle, page_ent);
+		set(page_ent, IS_VALID);
+	pthread_mutex_unlock(&(page_ent->page_entry_lock));
+
 	return 1;
 }
 
-static int release_used_page_entry(bufferpool* buffp, page_entry* page_ent, int okay_to_evict)
+// if a scan_ring is provided, and if the page_entry is a frame of the ring, then it is not returned to the lru
+static void release_used_page_entry(bufferpool* buffp, page_entry* page_ent, page_latch_mode latch_mode, int okay_to_evict, scan_ring* ring)
 {
-	int lock_released = 0;
-	int was_modified;
+	// the page_id must be read, while we still hold the pin on the page
+	trace_page_access(buffp, RELEASE_EVENT, page_ent->page_id, latch_mode, 0, okay_to_evict);
 
-	// figure out, if we need to release read lock or write lock on the page_entry memory, and release it, 
+	// release the read lock or write lock on the page_entry memory, as held by the user thread, 
 	// mark the page as modified if the page was acquired for being written by the user thread
-	if(get_readers_count(&(page_ent->page_memory_lock)))
-	{
-		release_read_lock(page_ent);
-		lock_released = 1;
-		was_modified = 0;
-	}
-	else if(get_writers_count(&(page_ent->page_memory_lock)))
-	{
+	int was_modified = (latch_mode == WRITER_LATCH);
+	if(was_modified)
 		release_write_lock(page_ent);
-		lock_released = 1;
-		was_modified = 1;
-	}
+	else
+		release_read_lock(page_ent);
 
 	// necessary task once the lock page_entry memory is released
 	// 1. unpin the page
 	// 2. and if modified mark the page as dirty
 	// 3. if it is not pinned by any user thread yet, we have to return the page to the LRU
-	if(lock_released)
+	pthread_mutex_lock(&(page_ent->page_entry_lock));
+		page_ent->pinned_by_count--;
+		if(was_modified)
+		{	// if the page was modified by the user it is now dirty as well as it holds valid data
+			set_page_entry_dirty(buffp->dirty_throttle, page_ent);
+			set(page_ent, IS_VALID);
+		}
+		if(page_ent->pinned_by_count == 0 && (ring == NULL || !is_frame_in_scan_ring(ring, page_ent)))
+		{
+			if(!okay_to_evict)
+				mark_as_recently_used(buffp->lru_p, page_ent);
+			else
+				mark_as_evictable(buffp->lru_p, page_ent);
+		}
+	pthread_mutex_unlock(&(page_ent->page_entry_lock));
+}
+
+int release_page_lock(bufferpool* buffp, page_handle* pg_handle, int okay_to_evict)
+{
+	page_entry* page_ent = get_page_entry_for_page_handle(buffp, pg_handle);
+
+	if(page_ent == NULL)
+		return 0;
+
+	release_used_page_entry(buffp, page_ent, pg_handle->latch_mode, okay_to_evict, NULL);
+
+	// the handle can not be used to access the page anymore
+	pg_handle->page_memory = NULL;
+	pg_handle->latch_mode = NO_LATCH;
+
+	return 1;
+}
+
+static page_handle acquire_page_for_scan(bufferpool* buffp, scan_ring* ring, PAGE_ID page_id, page_latch_mode latch_mode)
+{
+	TIMESTAMP_ns start_timestamp;
+	setToCurrentMonotonicTimestamp_ns(start_timestamp);
+
+	// pace the writer, if there are too many dirty pages
+	if(latch_mode == WRITER_LATCH && balance_dirty_pages(buffp))
+		increment_stat(buffp->stats, writers_throttled);
+
+	int is_miss = 0;
+	page_entry* page_ent = fetch_page_entry(buffp, page_id, ring, &is_miss);
+
+	// the frame that the missed page was read into, now belongs to the ring
+	// pages that were hit are not adopted, they belong to the working set of the rest of the bufferpool
+	if(is_miss)
 	{
-		pthread_mutex_lock(&(page_ent->page_entry_lock));
-			page_ent->pinned_by_count--;
-			if(was_modified)
-			{	// if the page was modified by the user it is now dirty as well as it holds valid data
-				set(page_ent, IS_DIRTY);
-				set(page_ent, IS_VALID);
-			}
-			if(page_ent->pinned_by_count == 0)
-			{
-				if(!okay_to_evict)
-					mark_as_recently_used(buffp->lru_p, page_ent);
-				else
-					mark_as_evictable(buffp->lru_p, page_ent);
-			}
-		pthread_mutex_unlock(&(page_ent->page_entry_lock));
+		page_entry* dropped_frame = adopt_frame_in_scan_ring(ring, page_ent);
+		if(dropped_frame != NULL)
+			return_frame_to_lru(buffp, dropped_frame);
 	}
 
-	return lock_released;
+	if(latch_mode == WRITER_LATCH)
+		acquire_write_lock(page_ent);
+	else
+		acquire_read_lock(page_ent);
+
+	record_latency_since(buffp->stats, ACQUIRE_PAGE_LATENCY, start_timestamp);
+	trace_page_access(buffp, ACQUIRE_EVENT, page_id, latch_mode, is_miss, 0);
+
+	return get_page_handle(buffp, page_ent, latch_mode);
 }
 
-int release_page_lock(bufferpool* buffp, void* page_memory, int okay_to_evict)
+page_handle acquire_page_with_reader_lock_for_scan(bufferpool* buffp, scan_ring* ring, PAGE_ID page_id)
 {
-	page_entry* page_ent = find_page_entry_by_page_memory(buffp->pg_tbl, page_memory);
+	return acquire_page_for_scan(buffp, ring, page_id, READER_LATCH);
+}
 
-	return release_used_page_entry(buffp, page_ent, okay_to_evict);
+page_handle acquire_page_with_writer_lock_for_scan(bufferpool* buffp, scan_ring* ring, PAGE_ID page_id)
+{
+	return acquire_page_for_scan(buffp, ring, page_id, WRITER_LATCH);
 }
 
-void request_page_prefetch(bufferpool* buffp, PAGE_ID start_page_id, PAGE_COUNT page_count, bbqueue* bbq)
+int release_page_lock_for_scan(bufferpool* buffp, scan_ring* ring, page_handle* pg_handle)
+{
+	page_entry* page_ent = get_page_entry_for_page_handle(buffp, pg_handle);
+
+	if(page_ent == NULL)
+		return 0;
+
+	release_used_page_entry(buffp, page_ent, pg_handle->latch_mode, 0, ring);
+
+	// the handle can not be used to access the page anymore
+	pg_handle->page_memory = NULL;
+	pg_handle->latch_mode = NO_LATCH;
+
+	return 1;
+}
+
+prefetch_handle request_page_prefetch(bufferpool* buffp, PAGE_ID start_page_id, PAGE_COUNT page_count, bbqueue* bbq)
 {
 	// you must provide a bbqueue to let us know, where do you want the result, when the page is brought to memory
 	if(bbq != NULL)
 	{
 		// for each page_id search the request mapper hashmap, to get an already created page request, if not, create one for this page_id
 		// do not request for reference of the page_request, since we will not be immediately waiting for getting page_entry from the page_request
+		add_to_stat(buffp->stats, pages_prefetched, page_count);
+
 		PAGE_ID page_id = start_page_id;
 		for(PAGE_COUNT i = 0; i < page_count; i++)
 		{
+			trace_page_access(buffp, PREFETCH_EVENT, page_id, NO_LATCH, 0, 0);
 			if(find_page_entry_by_page_id(buffp->pg_tbl, page_id) != NULL)
 				push_bbqueue(bbq, page_id);
 			else
-				find_or_create_request_for_page_id(buffp->rq_tracker, page_id, buffp, bbq, NULL);
+				find_or_create_request_for_page_id(buffp->rq_tracker, page_id, PREFETCH_REQUEST, buffp, bbq, NULL, NULL);
+			page_id++;
+		}
+	}
+
+	return (prefetch_handle){
+		.start_page_id = start_page_id,
+		.page_count = (bbq != NULL) ? page_count : 0,
+		.bbq = bbq,
+	};
+}
+
+PAGE_COUNT cancel_page_prefetch(bufferpool* buffp, prefetch_handle* pf_handle)
+{
+	PAGE_COUNT pages_cancelled = 0;
+
+	if(pf_handle->bbq != NULL)
+	{
+		PAGE_ID page_id = pf_handle->start_page_id;
+		for(PAGE_COUNT i = 0; i < pf_handle->page_count; i++)
+		{
+			if(cancel_page_request_for_bbqueue(buffp->rq_tracker, page_id, buffp, pf_handle->bbq))
+				pages_cancelled++;
 			page_id++;
 		}
 	}
+
+	// a prefetch_handle can be cancelled only once
+	pf_handle->page_count = 0;
+
+	add_to_stat(buffp->stats, prefetched_pages_cancelled, pages_cancelled);
+
+	return pages_cancelled;
+}
+
+void set_elevator_dispatch(bufferpool* buffp, uint8_t priority_band)
+{
+	set_elevator_priority_band(buffp->rq_prioritizer, priority_band);
+}
+
+int dump_resident_pages(bufferpool* buffp, char* dump_file_name)
+{
+	return write_resident_pages_dump(buffp, dump_file_name);
+}
+
+void dump_resident_pages_on_delete(bufferpool* buffp, char* dump_file_name)
+{
+	if(buffp->resident_pages_dump_file_name != NULL)
+		free(buffp->resident_pages_dump_file_name);
+	buffp->resident_pages_dump_file_name = (dump_file_name != NULL) ? strdup(dump_file_name) : NULL;
+}
+
+PAGE_COUNT warm_up_bufferpool(bufferpool* buffp, char* dump_file_name)
+{
+	return load_resident_pages_dump(buffp, dump_file_name);
+}
+
+void set_read_ahead_window(bufferpool* buffp, PAGE_COUNT max_window)
+{
+	// read ahead must not be allowed to occupy a considerable part of the bufferpool
+	if(max_window > buffp->pages_in_bufferpool / 4)
+		max_window = buffp->pages_in_bufferpool / 4;
+
+	if(buffp->ra_detector != NULL)
+		delete_read_ahead_detector(buffp->ra_detector);
+	buffp->ra_detector = (max_window > 0) ? get_read_ahead_detector(max_window) : NULL;
+}
+
+void set_shadow_copy_writeback(bufferpool* buffp, int enable)
+{
+	buffp->shadow_copy_writeback = enable;
+}
+
+void set_page_checksums(bufferpool* buffp, int enable)
+{
+	buffp->page_checksums = enable;
+}
+
+int set_page_compression(bufferpool* buffp, char* extent_map_file_name)
+{
+	if(buffp->extent_map != NULL)
+		return 0;
+	buffp->extent_map = get_page_extent_map(extent_map_file_name);
+	return buffp->extent_map != NULL;
+}
+
+int set_hole_detection(bufferpool* buffp)
+{
+	if(buffp->hole_map != NULL)
+		return 0;
+	buffp->hole_map = get_page_hole_map(buffp->db_file, buffp->number_of_blocks_per_page);
+	return buffp->hole_map != NULL;
+}
+
+int set_numa_interleave(bufferpool* buffp)
+{
+	return interleave_memory_across_numa_nodes(buffp->page_memories, buffp->pages_in_bufferpool * buffp->number_of_blocks_per_page * get_block_size(buffp->db_file));
+}
+
+void set_compressed_page_cache_budget(bufferpool* buffp, uint64_t bytes_budget)
+{
+	set_compressed_page_cache_bytes_budget(buffp->compressed_cache, bytes_budget);
+}
+
+int set_l2_page_cache(bufferpool* buffp, char* l2_file_name, PAGE_COUNT l2_pages)
+{
+	if(buffp->l2_cache != NULL)
+		return 0;
+	buffp->l2_cache = get_l2_page_cache(l2_file_name, l2_pages, buffp->number_of_blocks_per_page * get_block_size(buffp->db_file));
+	return buffp->l2_cache != NULL;
+}
+
+void set_dirty_pages_ratio_limit(bufferpool* buffp, uint8_t dirty_percentage)
+{
+	PAGE_COUNT dirty_pages_limit = 0;
+	if(dirty_percentage > 0 && dirty_percentage < 100)
+	{
+		dirty_pages_limit = (((uint64_t)buffp->pages_in_bufferpool) * dirty_percentage) / 100;
+		// a limit of 0 would mean no limit
+		if(dirty_pages_limit == 0)
+			dirty_pages_limit = 1;
+	}
+	set_dirty_pages_limit(buffp->dirty_throttle, dirty_pages_limit);
 }
 
 void force_write(bufferpool* buffp, PAGE_ID page_id)
@@ -299,12 +637,201 @@ void force_write(bufferpool* buffp, PAGE_ID page_id)
 		pthread_mutex_unlock(&(page_ent->page_entry_lock));
 
 		if(is_cleanup_required)
+		{
+			TIMESTAMP_ns start_timestamp;
+			setToCurrentMonotonicTimestamp_ns(start_timestamp);
+
 			queue_and_wait_for_page_entry_clean_up_if_dirty(buffp, page_ent);
+
+			record_latency_since(buffp->stats, FORCE_WRITE_WAIT_LATENCY, start_timestamp);
+		}
+	}
+}
+
+int reserve_pages_on_disk(bufferpool* buffp, PAGE_ID start_page_id, PAGE_COUNT page_count)
+{
+	if(page_count == 0)
+		return 1;
+
+	int result = 1;
+
+	pthread_mutex_lock(&(buffp->reservation_lock));
+
+		// only the pages not already reserved (below the reserved_upto_page_id) are reserved, and the reservation is extended upto the end of its chunk
+		// so that the appends, that reserve a page at a time, reach the file system only once in a chunk
+		if(start_page_id + page_count > buffp->reserved_upto_page_id)
+		{
+			PAGE_COUNT chunk_pages = DISK_RESERVATION_CHUNK_SIZE / (buffp->number_of_blocks_per_page * get_block_size(buffp->db_file));
+			if(chunk_pages == 0)
+				chunk_pages = 1;
+
+			PAGE_ID reserve_from_page_id = (start_page_id > buffp->reserved_upto_page_id) ? start_page_id : buffp->reserved_upto_page_id;
+			PAGE_ID reserve_upto_page_id = ((start_page_id + page_count + chunk_pages - 1) / chunk_pages) * chunk_pages;
+
+			result = (allocate_blocks_on_disk(buffp->db_file, reserve_from_page_id * buffp->number_of_blocks_per_page, (reserve_upto_page_id - reserve_from_page_id) * buffp->number_of_blocks_per_page) == 0);
+
+			// the reserved_upto_page_id can move only if there is no gap of unreserved pages below the new reservation
+			if(result && reserve_from_page_id == buffp->reserved_upto_page_id)
+				buffp->reserved_upto_page_id = reserve_upto_page_id;
+		}
+
+	pthread_mutex_unlock(&(buffp->reservation_lock));
+
+	return result;
+}
+
+// returns 1, if the page is in the bufferpool and pinned by some user thread
+static int is_resident_page_pinned(bufferpool* buffp, PAGE_ID page_id)
+{
+	page_entry* page_ent = find_page_entry_by_page_id(buffp->pg_tbl, page_id);
+	if(page_ent == NULL)
+		return 0;
+
+	pthread_mutex_lock(&(page_ent->page_entry_lock));
+		int is_pinned = (page_ent->page_id == page_id && check(page_ent, IS_VALID) && page_ent->pinned_by_count > 0);
+	pthread_mutex_unlock(&(page_ent->page_entry_lock));
+
+	return is_pinned;
+}
+
+// removes the page from the bufferpool, discarding its contents (even if it is dirty)
+// returns 0 (without removing it), only if the page is pinned by some user thread
+static int drop_resident_page(bufferpool* buffp, PAGE_ID page_id)
+{
+	page_entry* page_ent = find_page_entry_by_page_id(buffp->pg_tbl, page_id);
+	if(page_ent == NULL)
+		return 1;
+
+	int is_dropped = 1;
+
+	pthread_mutex_lock(&(page_ent->page_entry_lock));
+
+		// wait for the shadow copy of the page being written, else the write could reallocate the slot after it is deallocated
+		// the clean up broadcasts force_write_wait, once it is done with the page
+		while(check(page_ent, IS_BEING_WRITTEN))
+			pthread_cond_wait(&(page_ent->force_write_wait), &(page_ent->page_entry_lock));
+
+		if(page_ent->page_id == page_id && check(page_ent, IS_VALID))
+		{
+			if(page_ent->pinned_by_count == 0)
+			{
+				discard_page_entry(buffp->pg_tbl, page_ent);
+				reset_page_entry_dirty(buffp->dirty_throttle, page_ent);
+				reset(page_ent, IS_VALID);
+
+				// the frame is free now, it is the first one to be replaced
+				mark_as_not_yet_used(buffp->lru_p, page_ent);
+			}
+			else
+				is_dropped = 0;
+		}
+
+	pthread_mutex_unlock(&(page_ent->page_entry_lock));
+
+	return is_dropped;
+}
+
+int free_pages_on_disk(bufferpool* buffp, PAGE_ID start_page_id, PAGE_COUNT page_count)
+{
+	if(page_count == 0)
+		return 1;
+
+	// a page in use must not lose its slot, so nothing is freed if any of the pages is pinned
+	for(PAGE_COUNT i = 0; i < page_count; i++)
+		if(is_resident_page_pinned(buffp, start_page_id + i))
+			return 0;
+
+	// the frames are dropped first, so that the pages are not written (nor evicted to the second tiers) after their slots are deallocated
+	// a page may still get pinned after the check above (the pages must not be used concurrently), then the slots are not deallocated
+	int are_all_dropped = 1;
+	for(PAGE_COUNT i = 0; i < page_count; i++)
+	{
+		PAGE_ID page_id = start_page_id + i;
+		are_all_dropped = drop_resident_page(buffp, page_id) && are_all_dropped;
+		remove_from_compressed_page_cache(buffp->compressed_cache, page_id);
+		if(buffp->l2_cache != NULL)
+			invalidate_in_l2_page_cache(buffp->l2_cache, page_id);
+	}
+	if(!are_all_dropped)
+		return 0;
+
+	// the reserved_upto_page_id is not moved back, the freed pages are never reserved again by reserve_pages_on_disk,
+	// since that would preallocate the holes that were just punched, a freed page gets its disk space back, only when it is written
+	pthread_mutex_lock(&(buffp->reservation_lock));
+		int result = (deallocate_blocks_on_disk(buffp->db_file, start_page_id * buffp->number_of_blocks_per_page, page_count * buffp->number_of_blocks_per_page) == 0);
+	pthread_mutex_unlock(&(buffp->reservation_lock));
+
+	// the slots read as zeros now, whether they were stored compressed or not
+	for(PAGE_COUNT i = 0; result && i < page_count; i++)
+	{
+		PAGE_ID page_id = start_page_id + i;
+		if(buffp->extent_map != NULL)
+			forget_page_extent(buffp->extent_map, page_id);
+		if(buffp->hole_map != NULL)
+			mark_page_hole(buffp->hole_map, page_id);
 	}
+
+	return result;
+}
+
+void get_bufferpool_stats(bufferpool* buffp, bufferpool_stats* stats)
+{
+	aggregate_stats_shards(buffp->stats, stats);
+}
+
+void get_bufferpool_latency_histogram(bufferpool* buffp, bufferpool_latency latency, latency_histogram* hist)
+{
+	aggregate_latency_histograms_of_stats_shards(buffp->stats, latency, hist);
+}
+
+int start_page_access_trace(bufferpool* buffp, char* trace_file_name, uint32_t trace_buffer_size)
+{
+	if(__atomic_load_n(&(buffp->tracer), __ATOMIC_SEQ_CST) != NULL)
+		return 0;
+
+	page_access_tracer* pat_p = start_page_access_tracer(trace_file_name, trace_buffer_size, buffp->number_of_blocks_per_page * get_block_size(buffp->db_file), buffp->pages_in_bufferpool);
+	if(pat_p == NULL)
+		return 0;
+
+	// some other thread may have started tracing concurrently
+	page_access_tracer* expected = NULL;
+	if(!__atomic_compare_exchange_n(&(buffp->tracer), &expected, pat_p, 0, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST))
+	{
+		stop_page_access_tracer(pat_p);
+		return 0;
+	}
+
+	return 1;
+}
+
+int stop_page_access_trace(bufferpool* buffp)
+{
+	page_access_tracer* pat_p = __atomic_exchange_n(&(buffp->tracer), NULL, __ATOMIC_SEQ_CST);
+	if(pat_p == NULL)
+		return 0;
+
+	// wait for the threads that are still recording in the tracer
+	while(__atomic_load_n(&(buffp->tracer_users), __ATOMIC_ACQUIRE) > 0)
+		sched_yield();
+
+	stop_page_access_tracer(pat_p);
+
+	return 1;
 }
 
 void delete_bufferpool(bufferpool* buffp)
 {
+	// complete the trace file, if the bufferpool is being traced
+	stop_page_access_trace(buffp);
+
+	// dump the resident pages, while they are still in the bufferpool
+	if(buffp->resident_pages_dump_file_name != NULL)
+	{
+		if(!write_resident_pages_dump(buffp, buffp->resident_pages_dump_file_name))
+			printf("could not write the resident pages dump to %s\n", buffp->resident_pages_dump_file_name);
+		free(buffp->resident_pages_dump_file_name);
+	}
+
 	// call shutdown on the bufferpool
 	buffp->SHUTDOWN_CALLED = 1;
 
@@ -312,9 +839,29 @@ void delete_bufferpool(bufferpool* buffp)
 	wait_for_shutdown_cleanup_scheduler(buffp);
 
 	// the io_dispatcher has to be shutdown aswell, but only after it complets, all the io jobs that have been submitted it uptill now
-	shutdown_executor(buffp->io_dispatcher, 0);
-	wait_for_all_threads_to_complete(buffp->io_dispatcher);
-	delete_executor(buffp->io_dispatcher);
+	shutdown_executor(buffp->read_io_dispatcher, 0);
+	wait_for_all_threads_to_complete(buffp->read_io_dispatcher);
+	delete_executor(buffp->read_io_dispatcher);
+
+	shutdown_executor(buffp->write_io_dispatcher, 0);
+	wait_for_all_threads_to_complete(buffp->write_io_dispatcher);
+	delete_executor(buffp->write_io_dispatcher);
+
+	munmap(buffp->writeback_staging_memories, buffp->write_io_thread_count * buffp->number_of_blocks_per_page * get_block_size(buffp->db_file));
+
+	if(buffp->extent_map != NULL)
+		delete_page_extent_map(buffp->extent_map);
+
+	if(buffp->hole_map != NULL)
+		delete_page_hole_map(buffp->hole_map);
+
+	pthread_mutex_destroy(&(buffp->reservation_lock));
+
+	delete_compressed_page_cache(buffp->compressed_cache);
+
+	// the pending writes to the l2_page_cache were completed by the write_io_dispatcher
+	if(buffp->l2_cache != NULL)
+		delete_l2_page_cache(buffp->l2_cache);
 
 	// free all the memory that the buffer pool acquired for all the page_entries to capture frames
 	munmap(buffp->page_memories, buffp->pages_in_bufferpool * buffp->number_of_blocks_per_page * get_block_size(buffp->db_file));
@@ -334,6 +881,11 @@ void delete_bufferpool(bufferpool* buffp)
 	delete_page_table(buffp->pg_tbl);
 	delete_page_request_tracker(buffp->rq_tracker);
 	delete_page_request_prioritizer(buffp->rq_prioritizer);
+	delete_shared_scan_coordinator(buffp->scan_coordinator);
+	if(buffp->ra_detector != NULL)
+		delete_read_ahead_detector(buffp->ra_detector);
+	delete_dirty_page_throttle(buffp->dirty_throttle);
+	delete_stats_shards(buffp->stats);
 
 	// free the buffer pool struct
 	free(buffp);
@@ -40,8 +40,8 @@ static int check_and_queue_if_cleanup_required(bufferpool* buffp, PAGE_COUNT ind
 				(page_ent->pinned_by_count + page_ent->usage_count == 0) && 
 				(currentTimeStamp >= page_ent->unix_timestamp_since_last_disk_io_in_ms + buffp->unused_prefetched_page_return_in_ms))
 			{
-				// this results from error prone code or overuse of pre-fetching, so it is completely viable to print such errors 
-				printf("UNUNSED PREFETCHED PAGE %u at index %u was returned to buferpool\n", page_ent->page_id, index);
+				// this results from error prone code or overuse of pre-fetching (or read ahead), it is counted in the unused_prefetched_pages stat
+				increment_stat(buffp->stats, unused_prefetched_pages);
 				mark_as_not_yet_used(buffp->lru_p, page_ent);
 				clean_up_required = 0;
 			}
@@ -72,9 +72,17 @@ static void* cleanup_scheduler_task_function(void* param)
 	}
 
 	// loop over all the page entries before quit to ensure that all the pages have reached the disk
+	// the unused prefetched (or read ahead) pages are also returned to the LRU right away, as there is no one left to return them after we quit,
+	// else the io threads still fulfilling the read ahead page requests could wait forever for the LRU to be non empty
 	for(PAGE_COUNT index = 0; index < buffp->pages_in_bufferpool; index++)
 	{
 		page_entry* page_ent = buffp->page_entries + index;
+
+		pthread_mutex_lock(&(page_ent->page_entry_lock));
+			if(check(page_ent, IS_VALID) && !is_page_entry_present_in_lru(buffp->lru_p, page_ent) && (page_ent->pinned_by_count + page_ent->usage_count == 0))
+				mark_as_not_yet_used(buffp->lru_p, page_ent);
+		pthread_mutex_unlock(&(page_ent->page_entry_lock));
+
 		queue_page_entry_clean_up_if_dirty(buffp, page_ent);
 	}
 
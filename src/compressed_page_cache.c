@@ -0,0 +1,146 @@
+#include<compressed_page_cache.h>
+
+#include<page_id_helper_functions.h>
+#include<lz4_codec.h>
+
+#include<stddef.h>
+#include<string.h>
+
+// the initial bucket count of the compressed_page_map, it is doubled every time the compressed pages outnumber the buckets
+#define INITIAL_BUCKET_COUNT 1024
+
+static unsigned int hash_compressed_page(const void* cp)
+{
+	return hash_page_id(((compressed_page*)cp)->page_id);
+}
+
+static int compare_compressed_pages(const void* cp1, const void* cp2)
+{
+	return compare_page_id(((compressed_page*)cp1)->page_id, ((compressed_page*)cp2)->page_id);
+}
+
+compressed_page_cache* get_compressed_page_cache()
+{
+	compressed_page_cache* cpc = malloc(sizeof(compressed_page_cache));
+	pthread_mutex_init(&(cpc->cache_lock), NULL);
+	initialize_hashmap(&(cpc->compressed_page_map), ELEMENTS_AS_LINKEDLIST, INITIAL_BUCKET_COUNT, hash_compressed_page, compare_compressed_pages, offsetof(compressed_page, map_node));
+	initialize_linkedlist(&(cpc->compressed_pages_lru), offsetof(compressed_page, lru_node));
+	cpc->bytes_used = 0;
+	cpc->bytes_budget = 0;
+	return cpc;
+}
+
+// removes the compressed_page from the cache, the caller must hold the cache_lock and free the compressed_page
+static void remove_compressed_page(compressed_page_cache* cpc, compressed_page* cp)
+{
+	remove_from_hashmap(&(cpc->compressed_page_map), cp);
+	remove_from_linkedlist(&(cpc->compressed_pages_lru), cp);
+	cpc->bytes_used -= sizeof(compressed_page) + cp->compressed_size;
+}
+
+// evicts the oldest compressed pages, until the cache fits in its bytes_budget, the caller must hold the cache_lock
+static void evict_compressed_pages_over_budget(compressed_page_cache* cpc)
+{
+	while(cpc->bytes_used > cpc->bytes_budget && !is_empty_linkedlist(&(cpc->compressed_pages_lru)))
+	{
+		compressed_page* cp = (compressed_page*) get_head(&(cpc->compressed_pages_lru));
+		remove_compressed_page(cpc, cp);
+		free(cp);
+	}
+}
+
+void set_compressed_page_cache_bytes_budget(compressed_page_cache* cpc, uint64_t bytes_budget)
+{
+	pthread_mutex_lock(&(cpc->cache_lock));
+		cpc->bytes_budget = bytes_budget;
+		evict_compressed_pages_over_budget(cpc);
+	pthread_mutex_unlock(&(cpc->cache_lock));
+}
+
+int put_in_compressed_page_cache(compressed_page_cache* cpc, PAGE_ID page_id, const void* page_memory, SIZE_IN_BYTES page_size)
+{
+	// a racy read of the budget is enough to skip the compression, when the cache is disabled
+	if(cpc->bytes_budget == 0)
+		return 0;
+
+	// the page is compressed, without holding the cache_lock
+	SIZE_IN_BYTES max_compressed_size = page_size - (page_size / 8);
+	compressed_page* cp = malloc(sizeof(compressed_page) + max_compressed_size);
+	cp->page_id = page_id;
+	cp->compressed_size = lz4_compress(page_memory, page_size, cp->data, max_compressed_size);
+	if(cp->compressed_size == 0)
+	{
+		free(cp);
+		return 0;
+	}
+	cp = realloc(cp, sizeof(compressed_page) + cp->compressed_size);
+	initialize_llnode(&(cp->map_node));
+	initialize_llnode(&(cp->lru_node));
+
+	pthread_mutex_lock(&(cpc->cache_lock));
+
+		compressed_page* old_cp = (compressed_page*) find_equals_in_hashmap(&(cpc->compressed_page_map), cp);
+		if(old_cp != NULL)
+		{
+			remove_compressed_page(cpc, old_cp);
+			free(old_cp);
+		}
+
+		if(get_element_count_hashmap(&(cpc->compressed_page_map)) >= get_bucket_count_hashmap(&(cpc->compressed_page_map)))
+			resize_hashmap(&(cpc->compressed_page_map), 2 * get_bucket_count_hashmap(&(cpc->compressed_page_map)));
+
+		insert_in_hashmap(&(cpc->compressed_page_map), cp);
+		insert_tail(&(cpc->compressed_pages_lru), cp);
+		cpc->bytes_used += sizeof(compressed_page) + cp->compressed_size;
+
+		// this may evict the page we just put, if it alone is over the budget
+		evict_compressed_pages_over_budget(cpc);
+
+	pthread_mutex_unlock(&(cpc->cache_lock));
+
+	return 1;
+}
+
+int take_from_compressed_page_cache(compressed_page_cache* cpc, PAGE_ID page_id, void* page_memory, SIZE_IN_BYTES page_size)
+{
+	pthread_mutex_lock(&(cpc->cache_lock));
+		compressed_page dummy_cp = {.page_id = page_id};
+		compressed_page* cp = (compressed_page*) find_equals_in_hashmap(&(cpc->compressed_page_map), &dummy_cp);
+		if(cp != NULL)
+			remove_compressed_page(cpc, cp);
+	pthread_mutex_unlock(&(cpc->cache_lock));
+
+	if(cp == NULL)
+		return 0;
+
+	// the page is decompressed, without holding the cache_lock, the compressed_page is now owned only by us
+	int64_t decompressed_size = lz4_decompress(cp->data, cp->compressed_size, page_memory, page_size);
+	free(cp);
+
+	return decompressed_size == page_size;
+}
+
+void remove_from_compressed_page_cache(compressed_page_cache* cpc, PAGE_ID page_id)
+{
+	pthread_mutex_lock(&(cpc->cache_lock));
+		compressed_page dummy_cp = {.page_id = page_id};
+		compressed_page* cp = (compressed_page*) find_equals_in_hashmap(&(cpc->compressed_page_map), &dummy_cp);
+		if(cp != NULL)
+			remove_compressed_page(cpc, cp);
+	pthread_mutex_unlock(&(cpc->cache_lock));
+
+	free(cp);
+}
+
+void delete_compressed_page_cache(compressed_page_cache* cpc)
+{
+	while(!is_empty_linkedlist(&(cpc->compressed_pages_lru)))
+	{
+		compressed_page* cp = (compressed_page*) get_head(&(cpc->compressed_pages_lru));
+		remove_compressed_page(cpc, cp);
+		free(cp);
+	}
+	deinitialize_hashmap(&(cpc->compressed_page_map));
+	pthread_mutex_destroy(&(cpc->cache_lock));
+	free(cpc);
+}
\ No newline at end of file
@@ -131,6 +131,30 @@ int read_blocks_from_disk(dbfile* dbfile_p, void* blocks_in_main_memory, BLOCK_I
 	return read_blocks(dbfile_p->db_fd, blocks_in_main_memory, starting_block_id, num_blocks_to_read, get_block_size(dbfile_p));
 }
 
+int find_data_blocks_on_disk(dbfile* dbfile_p, BLOCK_ID from_block_id, BLOCK_ID* data_start_block_id, BLOCK_ID* data_end_block_id)
+{
+	return find_data_blocks(dbfile_p->db_fd, from_block_id, data_start_block_id, data_end_block_id, get_block_size(dbfile_p));
+}
+
+int get_current_block_count(dbfile* dbfile_p, BLOCK_COUNT* block_count)
+{
+	return get_file_block_count(dbfile_p->db_fd, block_count, get_block_size(dbfile_p));
+}
+
+int allocate_blocks_on_disk(dbfile* dbfile_p, BLOCK_ID starting_block_id, BLOCK_COUNT num_blocks_to_allocate)
+{
+	int result = allocate_blocks(dbfile_p->db_fd, starting_block_id, num_blocks_to_allocate, get_block_size(dbfile_p));
+	fstat(dbfile_p->db_fd, &(dbfile_p->dbfstat));
+	return result;
+}
+
+int deallocate_blocks_on_disk(dbfile* dbfile_p, BLOCK_ID starting_block_id, BLOCK_COUNT num_blocks_to_deallocate)
+{
+	int result = deallocate_blocks(dbfile_p->db_fd, starting_block_id, num_blocks_to_deallocate, get_block_size(dbfile_p));
+	fstat(dbfile_p->db_fd, &(dbfile_p->dbfstat));
+	return result;
+}
+
 int close_dbfile(dbfile* dbfile_p)
 {
 	if(close_db_file(dbfile_p->db_fd) == 0)
@@ -0,0 +1,168 @@
+#include<dirty_page_throttle.h>
+
+#include<bufferpool_struct_def.h>
+#include<io_dispatcher.h>
+
+#include<errno.h>
+#include<time.h>
+
+dirty_page_throttle* get_dirty_page_throttle()
+{
+	dirty_page_throttle* dpt = (dirty_page_throttle*) malloc(sizeof(dirty_page_throttle));
+	dpt->dirty_pages_count = 0;
+	dpt->dirty_pages_limit = 0;
+	dpt->writeback_cursor = 0;
+	pthread_mutex_init(&(dpt->writeback_cursor_lock), NULL);
+	pthread_mutex_init(&(dpt->over_limit_lock), NULL);
+	pthread_cond_init(&(dpt->over_limit_wait), NULL);
+	dpt->over_limit_waiters = 0;
+	return dpt;
+}
+
+void set_dirty_pages_limit(dirty_page_throttle* dpt, PAGE_COUNT dirty_pages_limit)
+{
+	pthread_mutex_lock(&(dpt->over_limit_lock));
+		__atomic_store_n(&(dpt->dirty_pages_limit), dirty_pages_limit, __ATOMIC_RELAXED);
+
+		// the limit may have been raised (or removed), let the waiting writers check again
+		pthread_cond_broadcast(&(dpt->over_limit_wait));
+	pthread_mutex_unlock(&(dpt->over_limit_lock));
+}
+
+void set_page_entry_dirty(dirty_page_throttle* dpt, page_entry* page_ent)
+{
+	if(!check(page_ent, IS_DIRTY))
+	{
+		set(page_ent, IS_DIRTY);
+		__atomic_add_fetch(&(dpt->dirty_pages_count), 1, __ATOMIC_RELAXED);
+	}
+}
+
+void reset_page_entry_dirty(dirty_page_throttle* dpt, page_entry* page_ent)
+{
+	if(check(page_ent, IS_DIRTY))
+	{
+		reset(page_ent, IS_DIRTY);
+		PAGE_COUNT dirty_pages_count = __atomic_sub_fetch(&(dpt->dirty_pages_count), 1, __ATOMIC_RELAXED);
+
+		// wake up the writers waiting for the dirty pages to fall below the limit
+		// over_limit_waiters is only read here without the lock, a waiter that is missed here will wake up by the timeout of its wait
+		PAGE_COUNT dirty_pages_limit = __atomic_load_n(&(dpt->dirty_pages_limit), __ATOMIC_RELAXED);
+		if(__atomic_load_n(&(dpt->over_limit_waiters), __ATOMIC_RELAXED) > 0 && (dirty_pages_limit == 0 || dirty_pages_count < dirty_pages_limit))
+		{
+			pthread_mutex_lock(&(dpt->over_limit_lock));
+				pthread_cond_broadcast(&(dpt->over_limit_wait));
+			pthread_mutex_unlock(&(dpt->over_limit_lock));
+		}
+	}
+}
+
+// the maximum number of page_entries, that the writeback cursor moves over in 1 push, this bounds the time a writer spends pushing it
+#define MAX_PAGE_ENTRIES_SCANNED_PER_PUSH 1024
+
+// queues the next pages_to_queue dirty pages (from the writeback cursor) for clean up
+// only 1 thread pushes the writeback cursor at a time, the other threads return immediately
+static void push_writeback_cursor(bufferpool* buffp, PAGE_COUNT pages_to_queue)
+{
+	dirty_page_throttle* dpt = buffp->dirty_throttle;
+
+	if(pthread_mutex_trylock(&(dpt->writeback_cursor_lock)) != 0)
+		return;
+
+	PAGE_COUNT max_pages_to_scan = (buffp->pages_in_bufferpool < MAX_PAGE_ENTRIES_SCANNED_PER_PUSH) ? buffp->pages_in_bufferpool : MAX_PAGE_ENTRIES_SCANNED_PER_PUSH;
+
+	PAGE_COUNT pages_queued = 0;
+	for(PAGE_COUNT pages_scanned = 0; pages_scanned < max_pages_to_scan && pages_queued < pages_to_queue; pages_scanned++)
+	{
+		page_entry* page_ent = buffp->page_entries + dpt->writeback_cursor;
+		dpt->writeback_cursor = (dpt->writeback_cursor + 1) % buffp->pages_in_bufferpool;
+
+		// a check without the page_entry_lock, only to avoid locking the clean page_entries
+		if(!check(page_ent, IS_DIRTY))
+			continue;
+
+		// the page_entry_lock is only tried (never waited for), a busy page_entry is skipped, it may be held by an io thread waiting for a latch, that our caller holds
+		// so the page_entry is also queued for clean up within the same trylocked section
+		if(pthread_mutex_trylock(&(page_ent->page_entry_lock)) != 0)
+			continue;
+
+		if(queue_page_entry_clean_up_if_dirty_unsafe(buffp, page_ent))
+			pages_queued++;
+
+		pthread_mutex_unlock(&(page_ent->page_entry_lock));
+	}
+
+	pthread_mutex_unlock(&(dpt->writeback_cursor_lock));
+}
+
+int balance_dirty_pages(bufferpool* buffp)
+{
+	dirty_page_throttle* dpt = buffp->dirty_throttle;
+
+	PAGE_COUNT dirty_pages_limit = __atomic_load_n(&(dpt->dirty_pages_limit), __ATOMIC_RELAXED);
+	if(dirty_pages_limit == 0)
+		return 0;
+
+	PAGE_COUNT background_limit = dirty_pages_limit / 2;
+	PAGE_COUNT setpoint = (background_limit + dirty_pages_limit) / 2;
+
+	PAGE_COUNT dirty_pages_count = __atomic_load_n(&(dpt->dirty_pages_count), __ATOMIC_RELAXED);
+	if(dirty_pages_count <= background_limit)
+		return 0;
+
+	// get the background writeback going, for the dirty pages above the background_limit
+	push_writeback_cursor(buffp, dirty_pages_count - background_limit);
+
+	if(dirty_pages_count <= setpoint)
+		return 0;
+
+	if(dirty_pages_count < dirty_pages_limit)
+	{
+		// pause proportional to how far we are from the setpoint, between the setpoint and the limit
+		uint64_t pause_us = (((uint64_t)MAX_WRITER_PAUSE_ms) * 1000 * (dirty_pages_count - setpoint)) / (dirty_pages_limit - setpoint);
+		struct timespec pause = {.tv_sec = pause_us / 1000000, .tv_nsec = (pause_us % 1000000) * 1000};
+		nanosleep(&pause, NULL);
+		return 1;
+	}
+
+	// at or over the limit, wait until the write io_dispatcher brings the dirty pages below the limit, but only for a bounded time
+	// the writer may be holding latches on other (dirty) pages, that the clean up of the write io_dispatcher has to lock,
+	// so an unbounded wait here could deadlock the writer with the io thread, that it waits for
+	pthread_mutex_lock(&(dpt->over_limit_lock));
+		dpt->over_limit_waiters++;
+		for(int wait_periods = 0; wait_periods < MAX_WRITER_OVER_LIMIT_WAIT_PERIODS; wait_periods++)
+		{
+			dirty_pages_limit = __atomic_load_n(&(dpt->dirty_pages_limit), __ATOMIC_RELAXED);
+			dirty_pages_count = __atomic_load_n(&(dpt->dirty_pages_count), __ATOMIC_RELAXED);
+			if(dirty_pages_limit == 0 || dirty_pages_count < dirty_pages_limit || buffp->SHUTDOWN_CALLED)
+				break;
+
+			// the wait is timed, so that we keep pushing the writeback cursor (the dirty pages may not yet be queued for clean up, if they were pinned)
+			struct timespec wait_until;
+			clock_gettime(CLOCK_REALTIME, &wait_until);
+			wait_until.tv_nsec += MAX_WRITER_PAUSE_ms * 1000000;
+			if(wait_until.tv_nsec >= 1000000000)
+			{
+				wait_until.tv_sec++;
+				wait_until.tv_nsec -= 1000000000;
+			}
+			if(pthread_cond_timedwait(&(dpt->over_limit_wait), &(dpt->over_limit_lock), &wait_until) == ETIMEDOUT)
+			{
+				pthread_mutex_unlock(&(dpt->over_limit_lock));
+					push_writeback_cursor(buffp, dirty_pages_count - background_limit);
+				pthread_mutex_lock(&(dpt->over_limit_lock));
+			}
+		}
+		dpt->over_limit_waiters--;
+	pthread_mutex_unlock(&(dpt->over_limit_lock));
+
+	return 1;
+}
+
+void delete_dirty_page_throttle(dirty_page_throttle* dpt)
+{
+	pthread_mutex_destroy(&(dpt->writeback_cursor_lock));
+	pthread_mutex_destroy(&(dpt->over_limit_lock));
+	pthread_cond_destroy(&(dpt->over_limit_wait));
+	free(dpt);
+}
\ No newline at end of file
@@ -52,6 +52,55 @@ int write_blocks(int db_fd, void* blocks_in_main_memory, BLOCK_COUNT block_id, B
 	return bytes_written;
 }
 
+int find_data_blocks(int db_fd, BLOCK_ID from_block_id, BLOCK_ID* data_start_block_id, BLOCK_ID* data_end_block_id, SIZE_IN_BYTES block_size)
+{
+#if defined SEEK_DATA && defined SEEK_HOLE
+	// the file offset is never used by the reads and writes (they are positioned), so it is okay to move it here
+	off_t data_start_offset = lseek(db_fd, ((off_t)from_block_id) * block_size, SEEK_DATA);
+	if(data_start_offset == -1)
+		return (errno == ENXIO) ? 0 : -1;
+
+	// the end of the file is also a hole
+	off_t data_end_offset = lseek(db_fd, data_start_offset, SEEK_HOLE);
+	if(data_end_offset == -1)
+		return -1;
+
+	(*data_start_block_id) = data_start_offset / block_size;
+	(*data_end_block_id) = (data_end_offset + block_size - 1) / block_size;
+	return 1;
+#else
+	return -1;
+#endif
+}
+
+int get_file_block_count(int db_fd, BLOCK_COUNT* block_count, SIZE_IN_BYTES block_size)
+{
+	// a local stat, the file is being written (and extended) by other threads while we call this
+	struct stat file_stat;
+	if(fstat(db_fd, &file_stat) == -1)
+		return -1;
+	(*block_count) = (file_stat.st_size + block_size - 1) / block_size;
+	return 0;
+}
+
+int allocate_blocks(int db_fd, BLOCK_ID block_id, BLOCK_COUNT block_count, SIZE_IN_BYTES block_size)
+{
+#if defined __linux__
+	return fallocate(db_fd, 0, ((off_t)block_id) * block_size, ((off_t)block_count) * block_size);
+#else
+	return -1;
+#endif
+}
+
+int deallocate_blocks(int db_fd, BLOCK_ID block_id, BLOCK_COUNT block_count, SIZE_IN_BYTES block_size)
+{
+#if defined __linux__
+	return fallocate(db_fd, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE, ((off_t)block_id) * block_size, ((off_t)block_count) * block_size);
+#else
+	return -1;
+#endif
+}
+
 int close_db_file(int db_fd)
 {
 	return close(db_fd);
@@ -2,6 +2,159 @@
 
 #include<bufferpool_struct_def.h>
 
+#include<page_checksum.h>
+
+// reads/writes the page of the page_entry, recording the time taken by the disk io
+static int timed_read_page_from_disk(bufferpool* buffp, page_entry* page_ent)
+{
+	TIMESTAMP_ns start_timestamp;
+	setToCurrentMonotonicTimestamp_ns(start_timestamp);
+
+	int result;
+	if(buffp->extent_map != NULL)
+	{
+		int was_compressed;
+		result = read_page_compressed(buffp->extent_map, buffp->db_file, page_ent->page_memory, page_ent->page_id, page_ent->start_block_id, page_ent->number_of_blocks, &was_compressed);
+		if(was_compressed)
+			increment_stat(buffp->stats, pages_read_compressed);
+	}
+	else
+		result = read_page_from_disk(page_ent, buffp->db_file);
+
+	record_latency_since(buffp->stats, DISK_READ_LATENCY, start_timestamp);
+
+	// only the pages read in full are verified, the pages beyond the end of the file were never written
+	// the page is still handed out, on a checksum failure, it is only counted and reported
+	SIZE_IN_BYTES page_size = page_ent->number_of_blocks * get_block_size(buffp->db_file);
+	if(buffp->page_checksums && result == page_size && !verify_page_checksum(page_ent->page_memory, page_size))
+	{
+		increment_stat(buffp->stats, checksum_failures);
+		printf("checksum verification failed for page %u\n", page_ent->page_id);
+	}
+
+	return result;
+}
+
+// writes the page_memory (the page_memory of the page_entry or its shadow copy) to the slot of the page, compressed if page compression is enabled
+// the checksum footer is stamped in the page_memory while only the read lock is held on the page,
+// this is safe because the users of the page never access its footer
+static int timed_write_page_memory_to_disk(bufferpool* buffp, void* page_memory, PAGE_ID page_id, BLOCK_ID start_block_id, BLOCK_COUNT number_of_blocks)
+{
+	if(buffp->page_checksums)
+		stamp_page_checksum(page_memory, number_of_blocks * get_block_size(buffp->db_file));
+
+	// the page is marked allocated before it is written, so that it is never taken for a hole, once its write starts
+	if(buffp->hole_map != NULL)
+		mark_page_allocated(buffp->hole_map, page_id);
+
+	TIMESTAMP_ns start_timestamp;
+	setToCurrentMonotonicTimestamp_ns(start_timestamp);
+
+	int result;
+	if(buffp->extent_map != NULL)
+	{
+		int is_compressed;
+		result = write_page_compressed(buffp->extent_map, buffp->db_file, page_memory, page_id, start_block_id, number_of_blocks, &is_compressed);
+		if(is_compressed)
+			increment_stat(buffp->stats, pages_written_compressed);
+	}
+	else
+		result = write_blocks_to_disk(buffp->db_file, page_memory, start_block_id, number_of_blocks);
+
+	record_latency_since(buffp->stats, DISK_WRITE_LATENCY, start_timestamp);
+
+	// the copy of the page in the l2_page_cache (if any) is now stale
+	if(buffp->l2_cache != NULL)
+		invalidate_in_l2_page_cache(buffp->l2_cache, page_id);
+
+	return result;
+}
+
+static int timed_write_page_to_disk(bufferpool* buffp, page_entry* page_ent)
+{
+	return timed_write_page_memory_to_disk(buffp, page_ent->page_memory, page_ent->page_id, page_ent->start_block_id, page_ent->number_of_blocks);
+}
+
+// clean the page entry here, before you discard it from hashmaps,
+// this will ensure that the page that is being evicted has reached to disk
+// before someone comes along and tries to read it again
+// if the page_entry is dirty and holds valid data, then write it to disk and clear the dirty bit
+// the page_entry_lock of the victim page_entry must be held by the caller
+static void clean_victim_page_entry(bufferpool* buffp, page_entry* page_ent)
+{
+	if(check(page_ent, IS_DIRTY) && check(page_ent, IS_VALID))
+	{
+		acquire_read_lock(page_ent);
+			timed_write_page_to_disk(buffp, page_ent);
+		release_read_lock(page_ent);
+
+		// since the cleanup is performed, the page is now not dirty
+		reset_page_entry_dirty(buffp->dirty_throttle, page_ent);
+
+		increment_stat(buffp->stats, writebacks_on_miss_path);
+	}
+}
+
+// returns the staging memory of the calling thread of the write_io_dispatcher of the bufferpool
+static void* get_writeback_staging_memory(bufferpool* buffp)
+{
+	// the threads of an executor only ever work for 1 bufferpool
+	static __thread bufferpool* staging_memory_of_bufferpool = NULL;
+	static __thread void* staging_memory = NULL;
+
+	if(staging_memory_of_bufferpool != buffp)
+	{
+		uint32_t index = __atomic_fetch_add(&(buffp->writeback_staging_memories_claimed), 1, __ATOMIC_RELAXED);
+		SIZE_IN_BYTES page_size = buffp->number_of_blocks_per_page * get_block_size(buffp->db_file);
+		staging_memory = buffp->writeback_staging_memories + (index % buffp->write_io_thread_count) * page_size;
+		staging_memory_of_bufferpool = buffp;
+	}
+
+	return staging_memory;
+}
+
+typedef struct l2_write_params l2_write_params;
+struct l2_write_params
+{
+	bufferpool* buffp;
+	uint32_t slot_index;
+
+	// a copy of the page, aligned to the block size of the l2 file, it is freed by the task
+	void* page_copy;
+};
+
+static void* io_l2_write_task(l2_write_params* l2wp)
+{
+	write_to_l2_page_cache_slot(l2wp->buffp->l2_cache, l2wp->slot_index, l2wp->page_copy);
+	increment_stat(l2wp->buffp->stats, pages_written_to_l2_cache);
+	free(l2wp->page_copy);
+	free(l2wp);
+	return NULL;
+}
+
+// copies the clean victim page_entry, and queues its write to the l2_page_cache on the write_io_dispatcher, so the page miss does not wait for it
+// the page_entry_lock of the victim page_entry must be held by the caller
+static void queue_victim_page_entry_for_l2_page_cache(bufferpool* buffp, page_entry* page_ent, SIZE_IN_BYTES page_size)
+{
+	void* page_copy = NULL;
+	if(posix_memalign(&page_copy, get_block_size(buffp->l2_cache->l2_file), page_size) != 0)
+		return;
+
+	uint32_t slot_index = reserve_l2_page_cache_slot(buffp->l2_cache, page_ent->page_id);
+	if(slot_index == NO_L2_SLOT)
+	{
+		free(page_copy);
+		return;
+	}
+
+	memcpy(page_copy, page_ent->page_memory, page_size);
+
+	l2_write_params* l2wp = malloc(sizeof(l2_write_params));
+	(*l2wp) = (l2_write_params){.buffp = buffp, .slot_index = slot_index, .page_copy = page_copy};
+
+	submit_job(buffp->write_io_dispatcher, (void*(*)(void*))io_l2_write_task, l2wp, NULL);
+}
+
 static void* io_page_replace_task(bufferpool* buffp)
 {
 	// get the page reqest that is most crucial to fulfill
@@ -9,11 +162,44 @@ static void* io_page_replace_task(bufferpool* buffp)
 	if(page_req_to_fulfill == NULL)
 		return NULL;
 
+	record_latency_since(buffp->stats, PAGE_REQUEST_QUEUE_LATENCY, page_req_to_fulfill->creation_timestamp_ns);
+
 	uint32_t page_id = page_req_to_fulfill->page_id;
 
+	// no one waits for a read ahead page, so it is not read once the bufferpool is shutting down, it would only take a frame out of the LRU
+	// a read ahead page_request that was later requested by a thread, has a higher request_class
+	if(buffp->SHUTDOWN_CALLED && page_req_to_fulfill->request_class == READ_AHEAD_REQUEST)
+	{
+		increment_page_request_reference_count(page_req_to_fulfill);
+		discard_page_request(buffp->rq_tracker, page_id);
+		fulfill_requested_page_entry_for_page_request(page_req_to_fulfill, NULL);
+		release_page_request_reference(page_req_to_fulfill);
+		return NULL;
+	}
+
 	// find page_ent, which will be victimized
 	page_entry* page_ent = NULL;
 
+	// if the requester has asked for a particular frame to be replaced, try to use it first
+	// it can be replaced only if it is not pinned, and only if it is not holding a page that was just read from disk and is yet to be used
+	// and only if it is not in the lru, a frame in the lru has been released by some other user of its page, it is part of the working set now, (and it may even hold some other page by now)
+	if(page_req_to_fulfill->frame_to_replace != NULL)
+	{
+		page_ent = page_req_to_fulfill->frame_to_replace;
+
+		pthread_mutex_lock(&(page_ent->page_entry_lock));
+
+		if(page_ent->pinned_by_count == 0 && (page_ent->usage_count > 0 || !check(page_ent, IS_VALID)) && !check(page_ent, IS_BEING_WRITTEN) && !is_page_entry_present_in_lru(buffp->lru_p, page_ent))
+		{
+			clean_victim_page_entry(buffp, page_ent);
+		}
+		else
+		{
+			pthread_mutex_unlock(&(page_ent->page_entry_lock));
+			page_ent = NULL;
+		}
+	}
+
 	while(page_ent == NULL)
 	{
 		wait_if_lru_is_empty(buffp->lru_p);
@@ -36,20 +222,16 @@ static void* io_page_replace_task(bufferpool* buffp)
 				// even though a page_entry may be provided as being fit for replacement, we need to ensure that 
 				if(page_ent->pinned_by_count == 0)
 				{
-					// clean the page entry here, before you discard it from hashmaps,
-					// this will ensure that the page that is being evicted has reached to disk
-					// before someone comes along and tries to read it again
-					// if the page_entry is dirty and holds valid data, then write it to disk and clear the dirty bit
-					if(check(page_ent, IS_DIRTY) && check(page_ent, IS_VALID))
+					// the page can not be replaced, while its shadow copy is being written, so it is returned to the lru
+					if(check(page_ent, IS_BEING_WRITTEN))
 					{
-						acquire_read_lock(page_ent);
-							write_page_to_disk(page_ent, buffp->db_file);
-						release_read_lock(page_ent);
-
-						// since the cleanup is performed, the page is now not dirty
-						reset(page_ent, IS_DIRTY);
+						mark_as_recently_used(buffp->lru_p, page_ent);
+						pthread_mutex_unlock(&(page_ent->page_entry_lock));
+						page_ent = NULL;
+						continue;
 					}
-					
+
+					clean_victim_page_entry(buffp, page_ent);
 					break;
 				}
 				else
@@ -66,15 +248,64 @@ static void* io_page_replace_task(bufferpool* buffp)
 	// then we need to read valid data from the page_id from the disk
 	if(page_ent->page_id != page_id || !check(page_ent, IS_VALID))
 	{
+		SIZE_IN_BYTES page_size = buffp->number_of_blocks_per_page * get_block_size(buffp->db_file);
+
+		if(check(page_ent, IS_VALID))
+		{
+			increment_stat(buffp->stats, evictions);
+			trace_page_access(buffp, EVICTION_EVENT, page_ent->page_id, NO_LATCH, 0, 0);
+
+			// the victim is clean now, it is put in the compressed_page_cache before it is discarded from the page_table,
+			// so that a page request for it, that comes after it is discarded, finds it in the compressed_page_cache
+			if(!check(page_ent, IS_DIRTY) && put_in_compressed_page_cache(buffp->compressed_cache, page_ent->page_id, page_ent->page_memory, page_size))
+				increment_stat(buffp->stats, pages_put_in_compressed_cache);
+
+			// and it is also written to the l2_page_cache, which is below the compressed_page_cache
+			if(!check(page_ent, IS_DIRTY) && buffp->l2_cache != NULL)
+				queue_victim_page_entry_for_l2_page_cache(buffp, page_ent, page_size);
+		}
+
 		discard_page_entry(buffp->pg_tbl, page_ent);
 
+		// the page is looked up in the compressed_page_cache, then in the l2_page_cache and then read from the heap file (unless it is a hole)
+		int is_read_from_compressed_cache = 0;
+		int is_read_from_l2_cache = 0;
+		int is_hole = 0;
 		acquire_write_lock(page_ent);
 			reset_page_to(page_ent, page_id, page_id * buffp->number_of_blocks_per_page, buffp->number_of_blocks_per_page);
-			read_page_from_disk(page_ent, buffp->db_file);
+			is_read_from_compressed_cache = take_from_compressed_page_cache(buffp->compressed_cache, page_id, page_ent->page_memory, page_size);
+			if(!is_read_from_compressed_cache && buffp->l2_cache != NULL)
+			{
+				is_read_from_l2_cache = read_from_l2_page_cache(buffp->l2_cache, page_id, page_ent->page_memory);
+
+				// a page that fails its checksum in the l2 file, is read again from the heap file
+				if(is_read_from_l2_cache && buffp->page_checksums && !verify_page_checksum(page_ent->page_memory, page_size))
+				{
+					invalidate_in_l2_page_cache(buffp->l2_cache, page_id);
+					is_read_from_l2_cache = 0;
+				}
+			}
+			if(!is_read_from_compressed_cache && !is_read_from_l2_cache)
+			{
+				is_hole = (buffp->hole_map != NULL && is_page_hole(buffp->hole_map, page_id));
+				if(is_hole)
+					memset(page_ent->page_memory, 0, page_size);
+				else
+					timed_read_page_from_disk(buffp, page_ent);
+			}
 		release_write_lock(page_ent);
 
+		if(is_read_from_compressed_cache)
+			increment_stat(buffp->stats, compressed_cache_hits);
+		else if(is_read_from_l2_cache)
+			increment_stat(buffp->stats, l2_cache_hits);
+		else if(is_hole)
+			increment_stat(buffp->stats, hole_pages_zero_filled);
+		else
+			increment_stat(buffp->stats, pages_read);
+
 		// the page now clean (not dirty) and has valid on-disk data
-		reset(page_ent, IS_DIRTY);
+		reset_page_entry_dirty(buffp->dirty_throttle, page_ent);
 		set(page_ent, IS_VALID);
 
 		// also reinitialize the usage count
@@ -88,9 +319,16 @@ static void* io_page_replace_task(bufferpool* buffp)
 
 	pthread_mutex_unlock(&(page_ent->page_entry_lock));
 
+	// the page_request must be discarded from the page_request_tracker, before it is fulfilled
+	// else a thread that finds the fulfilled page_entry already replaced, would keep finding this stale page_request in a loop, until it gets discarded
+	// the page_entry is already in the page_table, so no one creates a new page_request for it in the meantime
+	// we hold an extra reference to fulfill the page_request, after the page_request_tracker has given up its reference
+	increment_page_request_reference_count(page_req_to_fulfill);
+	discard_page_request(buffp->rq_tracker, page_req_to_fulfill->page_id);
+
 	fulfill_requested_page_entry_for_page_request(page_req_to_fulfill, page_ent);
 
-	discard_page_request(buffp->rq_tracker, page_req_to_fulfill->page_id);
+	release_page_request_reference(page_req_to_fulfill);
 	
 	return NULL;
 }
@@ -113,16 +351,45 @@ static void* io_clean_up_task(cleanup_params* cp)
 		pthread_mutex_lock(&(page_ent->page_entry_lock));
 
 			// clean up for the page, only if it is dirty and holds valid data
-			if(check(page_ent, IS_DIRTY) && check(page_ent, IS_VALID))
+			if(check(page_ent, IS_DIRTY) && check(page_ent, IS_VALID) && buffp->shadow_copy_writeback)
+			{
+				void* staging_memory = get_writeback_staging_memory(buffp);
+
+				// the page is clean from the moment it is copied, any write to it after the copy makes it dirty again
+				acquire_read_lock(page_ent);
+					memcpy(staging_memory, page_ent->page_memory, buffp->number_of_blocks_per_page * get_block_size(buffp->db_file));
+				release_read_lock(page_ent);
+				reset_page_entry_dirty(buffp->dirty_throttle, page_ent);
+
+				PAGE_ID page_id = page_ent->page_id;
+				BLOCK_ID start_block_id = page_ent->start_block_id;
+				BLOCK_COUNT number_of_blocks = page_ent->number_of_blocks;
+
+				set(page_ent, IS_BEING_WRITTEN);
+				pthread_mutex_unlock(&(page_ent->page_entry_lock));
+
+					timed_write_page_memory_to_disk(buffp, staging_memory, page_id, start_block_id, number_of_blocks);
+
+				pthread_mutex_lock(&(page_ent->page_entry_lock));
+				reset(page_ent, IS_BEING_WRITTEN);
+
+				increment_stat(buffp->stats, writebacks_by_cleanup);
+
+				// update the last_io timestamp, acknowledging when was the io performed
+				setToCurrentUnixTimestamp(page_ent->unix_timestamp_since_last_disk_io_in_ms);
+			}
+			else if(check(page_ent, IS_DIRTY) && check(page_ent, IS_VALID))
 			{
 				acquire_read_lock(page_ent);
-					write_page_to_disk(page_ent, buffp->db_file);
+					timed_write_page_to_disk(buffp, page_ent);
 				release_read_lock(page_ent);
 
 				// since the cleanup is performed, the page is now not dirty and holds valid data
-				reset(page_ent, IS_DIRTY);
+				reset_page_entry_dirty(buffp->dirty_throttle, page_ent);
 				set(page_ent, IS_VALID);
 
+				increment_stat(buffp->stats, writebacks_by_cleanup);
+
 				// update the last_io timestamp, acknowledging when was the io performed
 				setToCurrentUnixTimestamp(page_ent->unix_timestamp_since_last_disk_io_in_ms);
 			}
@@ -140,32 +407,41 @@ static void* io_clean_up_task(cleanup_params* cp)
 
 void queue_job_for_page_request(bufferpool* buffp)
 {
-	submit_job(buffp->io_dispatcher, (void*(*)(void*))io_page_replace_task, buffp, NULL);
+	submit_job(buffp->read_io_dispatcher, (void*(*)(void*))io_page_replace_task, buffp, NULL);
+}
+
+int queue_page_entry_clean_up_if_dirty_unsafe(bufferpool* buffp, page_entry* page_ent)
+{
+	if(check(page_ent, IS_DIRTY) && check(page_ent, IS_VALID) && !check(page_ent, IS_QUEUED_FOR_CLEANUP))
+	{
+		cleanup_params* cp = malloc(sizeof(cleanup_params));
+		(*cp) = (cleanup_params){.buffp = buffp, .page_ent = page_ent};
+		submit_job(buffp->write_io_dispatcher, (void* (*)(void*))io_clean_up_task, cp, NULL);
+		set(page_ent, IS_QUEUED_FOR_CLEANUP);
+		return 1;
+	}
+	return 0;
 }
 
 void queue_page_entry_clean_up_if_dirty(bufferpool* buffp, page_entry* page_ent)
 {
 	pthread_mutex_lock(&(page_ent->page_entry_lock));
-		if(check(page_ent, IS_DIRTY) && check(page_ent, IS_VALID) && !check(page_ent, IS_QUEUED_FOR_CLEANUP))
-		{
-			cleanup_params* cp = malloc(sizeof(cleanup_params));
-			(*cp) = (cleanup_params){.buffp = buffp, .page_ent = page_ent};
-			submit_job(buffp->io_dispatcher, (void* (*)(void*))io_clean_up_task, cp, NULL);
-			set(page_ent, IS_QUEUED_FOR_CLEANUP);
-		}
+		queue_page_entry_clean_up_if_dirty_unsafe(buffp, page_ent);
 	pthread_mutex_unlock(&(page_ent->page_entry_lock));
 }
 
 void queue_and_wait_for_page_entry_clean_up_if_dirty(bufferpool* buffp, page_entry* page_ent)
 {
 	pthread_mutex_lock(&(page_ent->page_entry_lock));
-		if(check(page_ent, IS_DIRTY) && check(page_ent, IS_VALID))
+		// with shadow copy writeback, the clean up that we wait for may have copied the page before its latest modifications,
+		// so we loop until the page is found clean
+		while(check(page_ent, IS_DIRTY) && check(page_ent, IS_VALID))
 		{
 			if(!check(page_ent, IS_QUEUED_FOR_CLEANUP))
 			{
 				cleanup_params* cp = malloc(sizeof(cleanup_params));
 				(*cp) = (cleanup_params){.buffp = buffp, .page_ent = page_ent};
-				submit_job(buffp->io_dispatcher, (void*(*)(void*))io_clean_up_task, &cp, NULL);
+				submit_job(buffp->write_io_dispatcher, (void*(*)(void*))io_clean_up_task, cp, NULL);
 				set(page_ent, IS_QUEUED_FOR_CLEANUP);
 			}
 
@@ -0,0 +1,181 @@
+#include<l2_page_cache.h>
+
+#include<page_id_helper_functions.h>
+
+static unsigned int hash_l2_slot_by_page_id(const void* slot)
+{
+	return hash_page_id(((l2_slot*)slot)->page_id);
+}
+
+static int compare_l2_slot_by_page_id(const void* slot1, const void* slot2)
+{
+	return compare_page_id(((l2_slot*)slot1)->page_id, ((l2_slot*)slot2)->page_id);
+}
+
+l2_page_cache* get_l2_page_cache(char* l2_file_name, PAGE_COUNT l2_pages, SIZE_IN_BYTES page_size)
+{
+	if(l2_pages == 0)
+		return NULL;
+
+	dbfile* l2_file = open_dbfile(l2_file_name);
+	if(l2_file == NULL)
+		l2_file = create_dbfile(l2_file_name);
+	if(l2_file == NULL)
+		return NULL;
+
+	SIZE_IN_BYTES block_size = get_block_size(l2_file);
+	if(page_size % block_size != 0)
+	{
+		printf("the page_size must be a multiple of %u, the block size of the l2 file\n", block_size);
+		close_dbfile(l2_file);
+		return NULL;
+	}
+
+	l2_page_cache* l2pc = malloc(sizeof(l2_page_cache));
+	l2pc->l2_file = l2_file;
+	l2pc->l2_pages = l2_pages;
+	l2pc->blocks_per_page = page_size / block_size;
+
+	// the l2 file is sized up front, so that the slot writes never extend it
+	resize_file(l2_file, l2_pages * l2pc->blocks_per_page);
+
+	pthread_mutex_init(&(l2pc->l2_lock), NULL);
+	l2pc->slots = malloc(sizeof(l2_slot) * l2_pages);
+	for(PAGE_COUNT i = 0; i < l2_pages; i++)
+		l2pc->slots[i] = (l2_slot){.state = L2_SLOT_FREE};
+	initialize_hashmap(&(l2pc->l2_slot_map), ROBINHOOD_HASHING, (l2_pages * 2) + 3, hash_l2_slot_by_page_id, compare_l2_slot_by_page_id, 0);
+	l2pc->clock_hand = 0;
+	l2pc->pending_slot_writes = 0;
+
+	return l2pc;
+}
+
+// frees a slot, the caller must hold the l2_lock
+static void free_l2_slot(l2_page_cache* l2pc, l2_slot* slot)
+{
+	remove_from_hashmap(&(l2pc->l2_slot_map), slot);
+	slot->state = L2_SLOT_FREE;
+	slot->is_invalidated = 0;
+	slot->is_referenced = 0;
+}
+
+// the caller must hold the l2_lock
+static l2_slot* find_l2_slot(l2_page_cache* l2pc, PAGE_ID page_id)
+{
+	l2_slot dummy_slot = {.page_id = page_id};
+	return (l2_slot*) find_equals_in_hashmap(&(l2pc->l2_slot_map), &dummy_slot);
+}
+
+uint32_t reserve_l2_page_cache_slot(l2_page_cache* l2pc, PAGE_ID page_id)
+{
+	uint32_t slot_index = NO_L2_SLOT;
+
+	pthread_mutex_lock(&(l2pc->l2_lock));
+
+		if(l2pc->pending_slot_writes < MAX_PENDING_L2_SLOT_WRITES && find_l2_slot(l2pc, page_id) == NULL)
+		{
+			// the hand goes around atmost twice, the first round may only clear the is_referenced bits
+			for(PAGE_COUNT steps = 0; steps < 2 * l2pc->l2_pages && slot_index == NO_L2_SLOT; steps++)
+			{
+				l2_slot* slot = l2pc->slots + l2pc->clock_hand;
+				uint32_t index = l2pc->clock_hand;
+				l2pc->clock_hand = (l2pc->clock_hand + 1) % l2pc->l2_pages;
+
+				if(slot->state == L2_SLOT_FREE)
+					slot_index = index;
+				else if(slot->state == L2_SLOT_VALID && slot->pinned_by_count == 0)
+				{
+					if(slot->is_referenced)
+						slot->is_referenced = 0;
+					else
+					{
+						free_l2_slot(l2pc, slot);
+						slot_index = index;
+					}
+				}
+			}
+
+			if(slot_index != NO_L2_SLOT)
+			{
+				l2_slot* slot = l2pc->slots + slot_index;
+				slot->page_id = page_id;
+				slot->state = L2_SLOT_BEING_WRITTEN;
+				insert_in_hashmap(&(l2pc->l2_slot_map), slot);
+				l2pc->pending_slot_writes++;
+			}
+		}
+
+	pthread_mutex_unlock(&(l2pc->l2_lock));
+
+	return slot_index;
+}
+
+void write_to_l2_page_cache_slot(l2_page_cache* l2pc, uint32_t slot_index, const void* page_memory)
+{
+	int bytes_written = write_blocks_to_disk(l2pc->l2_file, (void*)page_memory, slot_index * l2pc->blocks_per_page, l2pc->blocks_per_page);
+
+	pthread_mutex_lock(&(l2pc->l2_lock));
+
+		l2_slot* slot = l2pc->slots + slot_index;
+		if(slot->is_invalidated || bytes_written != l2pc->blocks_per_page * get_block_size(l2pc->l2_file))
+			free_l2_slot(l2pc, slot);
+		else
+			slot->state = L2_SLOT_VALID;
+
+		l2pc->pending_slot_writes--;
+
+	pthread_mutex_unlock(&(l2pc->l2_lock));
+}
+
+int read_from_l2_page_cache(l2_page_cache* l2pc, PAGE_ID page_id, void* page_memory)
+{
+	pthread_mutex_lock(&(l2pc->l2_lock));
+		l2_slot* slot = find_l2_slot(l2pc, page_id);
+		if(slot != NULL && slot->state == L2_SLOT_VALID && !slot->is_invalidated)
+		{
+			slot->pinned_by_count++;
+			slot->is_referenced = 1;
+		}
+		else
+			slot = NULL;
+	pthread_mutex_unlock(&(l2pc->l2_lock));
+
+	if(slot == NULL)
+		return 0;
+
+	int bytes_read = read_blocks_from_disk(l2pc->l2_file, page_memory, (slot - l2pc->slots) * l2pc->blocks_per_page, l2pc->blocks_per_page);
+	int is_read = (bytes_read == l2pc->blocks_per_page * get_block_size(l2pc->l2_file));
+
+	pthread_mutex_lock(&(l2pc->l2_lock));
+		slot->pinned_by_count--;
+
+		// a slot that can not be read, is not used again
+		if((!is_read || slot->is_invalidated) && slot->pinned_by_count == 0)
+			free_l2_slot(l2pc, slot);
+	pthread_mutex_unlock(&(l2pc->l2_lock));
+
+	return is_read;
+}
+
+void invalidate_in_l2_page_cache(l2_page_cache* l2pc, PAGE_ID page_id)
+{
+	pthread_mutex_lock(&(l2pc->l2_lock));
+		l2_slot* slot = find_l2_slot(l2pc, page_id);
+		if(slot != NULL)
+		{
+			if(slot->state == L2_SLOT_BEING_WRITTEN || slot->pinned_by_count > 0)
+				slot->is_invalidated = 1;
+			else
+				free_l2_slot(l2pc, slot);
+		}
+	pthread_mutex_unlock(&(l2pc->l2_lock));
+}
+
+void delete_l2_page_cache(l2_page_cache* l2pc)
+{
+	close_dbfile(l2pc->l2_file);
+	deinitialize_hashmap(&(l2pc->l2_slot_map));
+	pthread_mutex_destroy(&(l2pc->l2_lock));
+	free(l2pc->slots);
+	free(l2pc);
+}
\ No newline at end of file
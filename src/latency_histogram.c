@@ -0,0 +1,84 @@
+#include<latency_histogram.h>
+
+#include<string.h>
+
+void initialize_latency_histogram(latency_histogram* lh_p)
+{
+	memset(lh_p->buckets, 0, sizeof(lh_p->buckets));
+}
+
+static unsigned int get_bucket_index(TIME_ns latency)
+{
+	// the latencies lesser than the number of sub buckets, get a bucket each
+	if(latency < LATENCY_HISTOGRAM_SUB_BUCKETS)
+		return latency;
+
+	unsigned int highest_bit = 63 - __builtin_clzll(latency);
+	if(highest_bit >= LATENCY_HISTOGRAM_MAX_LATENCY_BITS)
+		return LATENCY_HISTOGRAM_BUCKETS - 1;
+
+	// the bits right below the highest set bit, give us the sub bucket
+	unsigned int shift = highest_bit - LATENCY_HISTOGRAM_SUB_BUCKET_BITS;
+	unsigned int sub_bucket = (latency >> shift) & (LATENCY_HISTOGRAM_SUB_BUCKETS - 1);
+
+	return (shift + 1) * LATENCY_HISTOGRAM_SUB_BUCKETS + sub_bucket;
+}
+
+// returns the largest latency that is counted in the bucket at the given index
+static TIME_ns get_largest_latency_of_bucket(unsigned int index)
+{
+	if(index < LATENCY_HISTOGRAM_SUB_BUCKETS)
+		return index;
+
+	unsigned int shift = (index / LATENCY_HISTOGRAM_SUB_BUCKETS) - 1;
+	unsigned int sub_bucket = index % LATENCY_HISTOGRAM_SUB_BUCKETS;
+
+	TIME_ns smallest_latency = ((TIME_ns)(LATENCY_HISTOGRAM_SUB_BUCKETS + sub_bucket)) << shift;
+	return smallest_latency + (((TIME_ns)1) << shift) - 1;
+}
+
+void record_in_latency_histogram(latency_histogram* lh_p, TIME_ns latency)
+{
+	__atomic_fetch_add(lh_p->buckets + get_bucket_index(latency), 1, __ATOMIC_RELAXED);
+}
+
+void merge_latency_histogram(latency_histogram* dest, const latency_histogram* src)
+{
+	for(unsigned int i = 0; i < LATENCY_HISTOGRAM_BUCKETS; i++)
+		dest->buckets[i] += __atomic_load_n(src->buckets + i, __ATOMIC_RELAXED);
+}
+
+uint64_t get_count_of_latency_histogram(const latency_histogram* lh_p)
+{
+	uint64_t count = 0;
+	for(unsigned int i = 0; i < LATENCY_HISTOGRAM_BUCKETS; i++)
+		count += lh_p->buckets[i];
+	return count;
+}
+
+TIME_ns get_percentile_of_latency_histogram(const latency_histogram* lh_p, double percentile)
+{
+	uint64_t count = get_count_of_latency_histogram(lh_p);
+	if(count == 0)
+		return 0;
+
+	if(percentile < 0.0)
+		percentile = 0.0;
+	else if(percentile > 100.0)
+		percentile = 100.0;
+
+	// the rank of the latency we are looking for, it is atleast 1 (the smallest latency)
+	uint64_t rank = (uint64_t)((percentile / 100.0) * count + 0.5);
+	if(rank == 0)
+		rank = 1;
+
+	uint64_t counted = 0;
+	for(unsigned int i = 0; i < LATENCY_HISTOGRAM_BUCKETS; i++)
+	{
+		counted += lh_p->buckets[i];
+		if(counted >= rank)
+			return get_largest_latency_of_bucket(i);
+	}
+
+	return get_largest_latency_of_bucket(LATENCY_HISTOGRAM_BUCKETS - 1);
+}
\ No newline at end of file
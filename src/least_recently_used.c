@@ -154,6 +154,15 @@ void mark_as_evictable(lru* lru_p, page_entry* page_ent)
 	pthread_mutex_unlock(&(lru_p->lru_lock));
 }
 
+void for_each_used_page_entry_in_lru(lru* lru_p, void (*operation)(const void* page_ent, const void* additional_params), const void* additional_params)
+{
+	pthread_mutex_lock(&(lru_p->lru_lock));
+		for_each_in_linkedlist(&(lru_p->evictable_page_entries), operation, additional_params);
+		for_each_in_linkedlist(&(lru_p->clean_page_entries), operation, additional_params);
+		for_each_in_linkedlist(&(lru_p->dirty_page_entries), operation, additional_params);
+	pthread_mutex_unlock(&(lru_p->lru_lock));
+}
+
 void delete_lru(lru* lru_p)
 {
 	pthread_cond_destroy(&(lru_p->wait_for_empty));
@@ -0,0 +1,193 @@
+#include<lz4_codec.h>
+
+#include<string.h>
+
+// the shortest match, that can be encoded
+#define MIN_MATCH 4
+
+// the farthest a match can be from the data that repeats it
+#define MAX_OFFSET 65535
+
+// the last match must start atleast these many bytes before the end, and the last these many bytes must be literals
+#define MATCH_START_LIMIT_FROM_END 12
+#define LAST_LITERALS 5
+
+#define HASH_TABLE_BITS 12
+
+static uint32_t read_uint32(const uint8_t* p)
+{
+	uint32_t v;
+	memcpy(&v, p, 4);
+	return v;
+}
+
+static uint32_t hash_sequence(uint32_t sequence)
+{
+	return (sequence * 2654435761U) >> (32 - HASH_TABLE_BITS);
+}
+
+// writes the length in excess of 15 (the part that does not fit in the token), in bytes of 255, returns NULL if dst_end is reached
+static uint8_t* write_length(uint8_t* op, uint8_t* dst_end, uint32_t length)
+{
+	for(; length >= 255; length -= 255)
+	{
+		if(op >= dst_end)
+			return NULL;
+		*op++ = 255;
+	}
+	if(op >= dst_end)
+		return NULL;
+	*op++ = length;
+	return op;
+}
+
+// writes a sequence of literals and a match (a match_length of 0, for the last literals), returns NULL if it does not fit before dst_end
+static uint8_t* write_sequence(uint8_t* op, uint8_t* dst_end, const uint8_t* literals, uint32_t literals_length, uint32_t offset, uint32_t match_length)
+{
+	if(op >= dst_end)
+		return NULL;
+	uint8_t* token = op++;
+
+	*token = ((literals_length >= 15) ? 15 : literals_length) << 4;
+	if(literals_length >= 15 && (op = write_length(op, dst_end, literals_length - 15)) == NULL)
+		return NULL;
+
+	if(dst_end - op < literals_length)
+		return NULL;
+	memcpy(op, literals, literals_length);
+	op += literals_length;
+
+	if(match_length == 0)
+		return op;
+
+	if(dst_end - op < 2)
+		return NULL;
+	*op++ = offset & 0xff;
+	*op++ = offset >> 8;
+
+	match_length -= MIN_MATCH;
+	*token |= (match_length >= 15) ? 15 : match_length;
+	if(match_length >= 15 && (op = write_length(op, dst_end, match_length - 15)) == NULL)
+		return NULL;
+
+	return op;
+}
+
+uint32_t lz4_compress(const void* src, uint32_t src_size, void* dst, uint32_t dst_capacity)
+{
+	const uint8_t* const src_start = src;
+	const uint8_t* const src_end = src_start + src_size;
+	uint8_t* op = dst;
+	uint8_t* const dst_end = op + dst_capacity;
+
+	const uint8_t* ip = src_start;
+	const uint8_t* anchor = src_start;
+
+	if(src_size > MATCH_START_LIMIT_FROM_END)
+	{
+		const uint8_t* const match_start_limit = src_end - MATCH_START_LIMIT_FROM_END;
+		const uint8_t* const match_end_limit = src_end - LAST_LITERALS;
+
+		// the positions (from src_start) of the last 4 byte sequences with each hash
+		uint32_t positions[1 << HASH_TABLE_BITS];
+		memset(positions, 0, sizeof(positions));
+
+		while(ip < match_start_limit)
+		{
+			uint32_t sequence = read_uint32(ip);
+			uint32_t hash = hash_sequence(sequence);
+			const uint8_t* ref = src_start + positions[hash];
+			positions[hash] = ip - src_start;
+
+			if(ref >= ip || ip - ref > MAX_OFFSET || read_uint32(ref) != sequence)
+			{
+				ip++;
+				continue;
+			}
+
+			uint32_t match_length = MIN_MATCH;
+			while(ip + match_length < match_end_limit && ref[match_length] == ip[match_length])
+				match_length++;
+
+			op = write_sequence(op, dst_end, anchor, ip - anchor, ip - ref, match_length);
+			if(op == NULL)
+				return 0;
+
+			ip += match_length;
+			anchor = ip;
+		}
+	}
+
+	op = write_sequence(op, dst_end, anchor, src_end - anchor, 0, 0);
+	if(op == NULL)
+		return 0;
+
+	return op - ((uint8_t*)dst);
+}
+
+// reads the length in excess of 15, returns 0 if src_end is reached
+static int read_length(const uint8_t** ip, const uint8_t* src_end, uint32_t* length)
+{
+	uint8_t b;
+	do
+	{
+		if((*ip) >= src_end)
+			return 0;
+		b = *(*ip)++;
+		(*length) += b;
+	}
+	while(b == 255);
+	return 1;
+}
+
+int64_t lz4_decompress(const void* src, uint32_t src_size, void* dst, uint32_t dst_capacity)
+{
+	const uint8_t* ip = src;
+	const uint8_t* const src_end = ip + src_size;
+	uint8_t* const dst_start = dst;
+	uint8_t* op = dst;
+	uint8_t* const dst_end = op + dst_capacity;
+
+	while(ip < src_end)
+	{
+		uint8_t token = *ip++;
+
+		uint32_t literals_length = token >> 4;
+		if(literals_length == 15 && !read_length(&ip, src_end, &literals_length))
+			return -1;
+		if(src_end - ip < literals_length || dst_end - op < literals_length)
+			return -1;
+		memcpy(op, ip, literals_length);
+		ip += literals_length;
+		op += literals_length;
+
+		// the last sequence has only literals
+		if(ip == src_end)
+			break;
+
+		if(src_end - ip < 2)
+			return -1;
+		uint32_t offset = ip[0] | (((uint32_t)ip[1]) << 8);
+		ip += 2;
+		if(offset == 0 || offset > op - dst_start)
+			return -1;
+
+		uint32_t match_length = token & 15;
+		if(match_length == 15 && !read_length(&ip, src_end, &match_length))
+			return -1;
+		match_length += MIN_MATCH;
+		if(dst_end - op < match_length)
+			return -1;
+
+		// the match may overlap the bytes it produces (offset < match_length), so it is copied byte by byte in that case
+		const uint8_t* ref = op - offset;
+		if(offset >= match_length)
+			memcpy(op, ref, match_length);
+		else
+			for(uint32_t i = 0; i < match_length; i++)
+				op[i] = ref[i];
+		op += match_length;
+	}
+
+	return op - dst_start;
+}
\ No newline at end of file
@@ -0,0 +1,73 @@
+#include<numa_placement.h>
+
+#include<stdio.h>
+#include<string.h>
+#include<unistd.h>
+#include<sys/syscall.h>
+
+// the memory policy constants of the mbind syscall, from linux/mempolicy.h (they are also in the numaif.h of libnuma)
+#define MPOL_INTERLEAVE_MODE	3
+#define MPOL_MF_MOVE_FLAG		(1 << 1)
+
+// the largest NUMA node number supported here
+#define MAX_NUMA_NODES 1024
+
+#define BITS_IN_UNSIGNED_LONG (8 * sizeof(unsigned long))
+
+// reads the list of the NUMA nodes with memory (like "0-1,3"), in to the node_mask, returns the number of the nodes in the list
+static int read_numa_nodes_with_memory(unsigned long node_mask[MAX_NUMA_NODES / BITS_IN_UNSIGNED_LONG])
+{
+	memset(node_mask, 0, (MAX_NUMA_NODES / BITS_IN_UNSIGNED_LONG) * sizeof(unsigned long));
+
+	FILE* f = fopen("/sys/devices/system/node/has_memory", "r");
+	if(f == NULL)
+		return 0;
+
+	int nodes_count = 0;
+	int first_node, last_node;
+	while(fscanf(f, "%d", &first_node) == 1)
+	{
+		last_node = first_node;
+
+		int c = fgetc(f);
+		if(c == '-')
+		{
+			if(fscanf(f, "%d", &last_node) != 1)
+				break;
+			c = fgetc(f);
+		}
+
+		for(int node = first_node; node <= last_node && node < MAX_NUMA_NODES; node++)
+		{
+			node_mask[node / BITS_IN_UNSIGNED_LONG] |= (1UL << (node % BITS_IN_UNSIGNED_LONG));
+			nodes_count++;
+		}
+
+		if(c != ',')
+			break;
+	}
+
+	fclose(f);
+	return nodes_count;
+}
+
+int get_numa_nodes_with_memory_count()
+{
+	unsigned long node_mask[MAX_NUMA_NODES / BITS_IN_UNSIGNED_LONG];
+	int nodes_count = read_numa_nodes_with_memory(node_mask);
+	return (nodes_count > 0) ? nodes_count : 1;
+}
+
+int interleave_memory_across_numa_nodes(void* memory, size_t size)
+{
+	unsigned long node_mask[MAX_NUMA_NODES / BITS_IN_UNSIGNED_LONG];
+	if(read_numa_nodes_with_memory(node_mask) <= 1)
+		return 0;
+
+#if defined SYS_mbind
+	// the pages already populated (by MAP_POPULATE, or by their use) are migrated to their interleaved nodes
+	return syscall(SYS_mbind, memory, size, MPOL_INTERLEAVE_MODE, node_mask, (unsigned long) MAX_NUMA_NODES, MPOL_MF_MOVE_FLAG) == 0;
+#else
+	return 0;
+#endif
+}
\ No newline at end of file
@@ -0,0 +1,181 @@
+#include<page_access_tracer.h>
+
+#include<bufferpool_struct_def.h>
+
+#include<string.h>
+#include<sched.h>
+
+// the maximum number of events, that the writer job writes at once
+#define WRITER_BATCH_SIZE 1024
+
+// the time the writer job sleeps for, when there are no events to be written
+#define WRITER_IDLE_SLEEP_ms 1
+
+// the thread_id of the calling thread, in the trace files, 0 means that it is not yet assigned
+static __thread uint32_t thread_id_of_this_thread = 0;
+
+static uint32_t next_thread_id = 1;
+
+static uint32_t get_thread_id_for_trace()
+{
+	if(thread_id_of_this_thread == 0)
+		thread_id_of_this_thread = __atomic_fetch_add(&next_thread_id, 1, __ATOMIC_RELAXED);
+	return thread_id_of_this_thread;
+}
+
+// writes all the published events, in batches, and returns the number of events written
+static uint64_t write_published_events(page_access_tracer* pat_p)
+{
+	page_access_trace_event batch[WRITER_BATCH_SIZE];
+	uint64_t events_written = 0;
+
+	while(1)
+	{
+		uint32_t batch_count = 0;
+		while(batch_count < WRITER_BATCH_SIZE)
+		{
+			trace_slot* slot = pat_p->slots + (pat_p->consume_position & (pat_p->ring_size - 1));
+			if(__atomic_load_n(&(slot->sequence), __ATOMIC_ACQUIRE) != pat_p->consume_position + 1)
+				break;
+
+			batch[batch_count++] = slot->event;
+
+			// the slot can be reserved again by the producers, in the next round of the ring buffer
+			__atomic_store_n(&(slot->sequence), pat_p->consume_position + pat_p->ring_size, __ATOMIC_RELEASE);
+			pat_p->consume_position++;
+		}
+
+		if(batch_count == 0)
+			break;
+
+		fwrite(batch, sizeof(page_access_trace_event), batch_count, pat_p->trace_file);
+		events_written += batch_count;
+	}
+
+	return events_written;
+}
+
+static void* trace_writer_task_function(void* param)
+{
+	page_access_tracer* pat_p = (page_access_tracer*) param;
+
+	while(!pat_p->stop_called)
+	{
+		if(write_published_events(pat_p) == 0)
+			sleepForMilliseconds(WRITER_IDLE_SLEEP_ms);
+	}
+
+	// no one is recording anymore, so write all the remaining events and quit
+	write_published_events(pat_p);
+
+	return NULL;
+}
+
+page_access_tracer* start_page_access_tracer(char* trace_file_name, uint32_t ring_size, uint32_t page_size, uint32_t pages_in_bufferpool)
+{
+	FILE* trace_file = fopen(trace_file_name, "wb");
+	if(trace_file == NULL)
+		return NULL;
+
+	// round up the ring_size to a power of 2
+	uint32_t ring_size_power_of_2 = 1;
+	while(ring_size_power_of_2 < ring_size && ring_size_power_of_2 < (1U << 31))
+		ring_size_power_of_2 <<= 1;
+
+	page_access_tracer* pat_p = (page_access_tracer*) aligned_alloc(CACHE_LINE_SIZE, sizeof(page_access_tracer));
+	pat_p->ring_size = ring_size_power_of_2;
+	pat_p->slots = (trace_slot*) malloc(sizeof(trace_slot) * pat_p->ring_size);
+	for(uint32_t i = 0; i < pat_p->ring_size; i++)
+		pat_p->slots[i].sequence = i;
+	pat_p->reserve_position = 0;
+	pat_p->events_dropped = 0;
+	pat_p->consume_position = 0;
+	pat_p->trace_file = trace_file;
+	pat_p->stop_called = 0;
+
+	// the header is written again at the end, with the final counts of the events
+	pat_p->file_header = (page_access_trace_file_header){
+		.magic = PAGE_ACCESS_TRACE_MAGIC,
+		.version = PAGE_ACCESS_TRACE_VERSION,
+		.event_size = sizeof(page_access_trace_event),
+		.page_size = page_size,
+		.pages_in_bufferpool = pages_in_bufferpool,
+		.reserved = 0,
+		.events_written = 0,
+		.events_dropped = 0,
+	};
+	fwrite(&(pat_p->file_header), sizeof(page_access_trace_file_header), 1, pat_p->trace_file);
+
+	pat_p->writer_completion_promise = get_promise();
+	pat_p->writer_job = get_job(trace_writer_task_function, pat_p, pat_p->writer_completion_promise);
+	execute_async(pat_p->writer_job);
+
+	return pat_p;
+}
+
+void record_in_page_access_tracer(page_access_tracer* pat_p, page_access_trace_event event)
+{
+	setToCurrentMonotonicTimestamp_ns(event.timestamp_ns);
+	event.thread_id = get_thread_id_for_trace();
+
+	uint64_t position = __atomic_load_n(&(pat_p->reserve_position), __ATOMIC_RELAXED);
+	while(1)
+	{
+		trace_slot* slot = pat_p->slots + (position & (pat_p->ring_size - 1));
+		uint64_t sequence = __atomic_load_n(&(slot->sequence), __ATOMIC_ACQUIRE);
+
+		if(sequence == position)
+		{
+			// the slot is free, try to reserve it, on failure position is updated to the current reserve_position
+			if(__atomic_compare_exchange_n(&(pat_p->reserve_position), &position, position + 1, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+			{
+				slot->event = event;
+				__atomic_store_n(&(slot->sequence), position + 1, __ATOMIC_RELEASE);
+				return;
+			}
+		}
+		else if(sequence < position)
+		{
+			// the slot has not yet been consumed by the writer job, since the last round, i.e. the ring buffer is full
+			__atomic_fetch_add(&(pat_p->events_dropped), 1, __ATOMIC_RELAXED);
+			return;
+		}
+		else // some other producer reserved this slot, retry with the new reserve_position
+			position = __atomic_load_n(&(pat_p->reserve_position), __ATOMIC_RELAXED);
+	}
+}
+
+void stop_page_access_tracer(page_access_tracer* pat_p)
+{
+	pat_p->stop_called = 1;
+
+	get_promised_result(pat_p->writer_completion_promise);
+	delete_promise(pat_p->writer_completion_promise);
+	delete_job(pat_p->writer_job);
+
+	// rewrite the header with the final counts
+	pat_p->file_header.events_written = pat_p->consume_position;
+	pat_p->file_header.events_dropped = pat_p->events_dropped;
+	fseek(pat_p->trace_file, 0, SEEK_SET);
+	fwrite(&(pat_p->file_header), sizeof(page_access_trace_file_header), 1, pat_p->trace_file);
+	fclose(pat_p->trace_file);
+
+	free(pat_p->slots);
+	free(pat_p);
+}
+
+void trace_page_access(bufferpool* buffp, page_access_trace_event_type event_type, PAGE_ID page_id, uint8_t latch_mode, uint8_t is_miss, uint8_t okay_to_evict)
+{
+	// when the bufferpool is not being traced, this is the only (read only) access to shared memory
+	if(__atomic_load_n(&(buffp->tracer), __ATOMIC_RELAXED) == NULL)
+		return;
+
+	// the tracer_users count ensures that the tracer is not stopped (and deleted), while we are recording in it
+	__atomic_fetch_add(&(buffp->tracer_users), 1, __ATOMIC_SEQ_CST);
+
+		page_access_tracer* pat_p = __atomic_load_n(&(buffp->tracer), __ATOMIC_SEQ_CST);
+		if(pat_p != NULL)
+			record_in_page_access_tracer(pat_p, (page_access_trace_event){.page_id = page_id, .event_type = event_type, .latch_mode = latch_mode, .is_miss = is_miss, .okay_to_evict = okay_to_evict});
+
+	__atomic_fetch_sub(&(buffp->tracer_users), 1, __ATOMIC_RELEASE);
+}
\ No newline at end of file
@@ -0,0 +1,205 @@
+#include<page_checksum.h>
+
+#include<string.h>
+#include<pthread.h>
+
+// reversed polynomial of CRC32C (castagnoli)
+#define CRC32C_POLYNOMIAL 0x82f63b78
+
+// the hardware implementation computes 3 independent crcs over 3 adjacent blocks of these sizes, and then combines them,
+// so that the 3 cycle latency of the crc32 instruction is hidden
+#define CRC32C_LONG_BLOCK_SIZE 1024
+#define CRC32C_SHORT_BLOCK_SIZE 256
+
+// tables of the slicing-by-8 portable implementation
+static uint32_t crc32c_table[8][256];
+
+// tables to shift a crc over a block of zeros (of the long and the short block size), 1 byte of the crc at a time
+static uint32_t crc32c_long_block_shift_table[4][256];
+static uint32_t crc32c_short_block_shift_table[4][256];
+
+static pthread_once_t crc32c_tables_initialized = PTHREAD_ONCE_INIT;
+
+// returns a * b modulo the polynomial, for a and b in the reflected representation (where x^0 is the highest bit)
+static uint32_t multiply_modulo_polynomial(uint32_t a, uint32_t b)
+{
+	uint32_t product = 0;
+	for(uint32_t m = ((uint32_t)1) << 31; m != 0; m >>= 1)
+	{
+		if(a & m)
+			product ^= b;
+		b = (b & 1) ? ((b >> 1) ^ CRC32C_POLYNOMIAL) : (b >> 1);
+	}
+	return product;
+}
+
+static void initialize_shift_table(uint32_t shift_table[4][256], size_t zeros_size)
+{
+	// shifting a crc over zeros_size bytes of zeros, multiplies it by x^(8 * zeros_size), so we first find x^(8 * zeros_size)
+	// it is the crc of zeros_size bytes of zeros, starting from x^0
+	uint32_t x_power = ((uint32_t)1) << 31;
+	for(size_t i = 0; i < zeros_size; i++)
+		x_power = (x_power >> 8) ^ crc32c_table[0][x_power & 0xff];
+
+	for(int k = 0; k < 4; k++)
+		for(uint32_t i = 0; i < 256; i++)
+			shift_table[k][i] = multiply_modulo_polynomial(x_power, i << (8 * k));
+}
+
+static void initialize_crc32c_tables()
+{
+	for(uint32_t i = 0; i < 256; i++)
+	{
+		uint32_t crc = i;
+		for(int bit = 0; bit < 8; bit++)
+			crc = (crc & 1) ? ((crc >> 1) ^ CRC32C_POLYNOMIAL) : (crc >> 1);
+		crc32c_table[0][i] = crc;
+	}
+
+	for(uint32_t i = 0; i < 256; i++)
+		for(int k = 1; k < 8; k++)
+			crc32c_table[k][i] = (crc32c_table[k - 1][i] >> 8) ^ crc32c_table[0][crc32c_table[k - 1][i] & 0xff];
+
+	initialize_shift_table(crc32c_long_block_shift_table, CRC32C_LONG_BLOCK_SIZE);
+	initialize_shift_table(crc32c_short_block_shift_table, CRC32C_SHORT_BLOCK_SIZE);
+}
+
+// all the crc_state-s below are not inverted (the inversions at the start and end of CRC32C are done by the callers)
+
+static uint32_t crc32c_portable(uint32_t crc_state, const unsigned char* data, size_t data_size)
+{
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+	while(data_size >= 8)
+	{
+		uint64_t word;
+		memcpy(&word, data, 8);
+		word ^= crc_state;
+		crc_state = crc32c_table[7][word & 0xff] ^ crc32c_table[6][(word >> 8) & 0xff] ^ crc32c_table[5][(word >> 16) & 0xff] ^ crc32c_table[4][(word >> 24) & 0xff]
+				^ crc32c_table[3][(word >> 32) & 0xff] ^ crc32c_table[2][(word >> 40) & 0xff] ^ crc32c_table[1][(word >> 48) & 0xff] ^ crc32c_table[0][word >> 56];
+		data += 8;
+		data_size -= 8;
+	}
+#endif
+
+	while(data_size > 0)
+	{
+		crc_state = (crc_state >> 8) ^ crc32c_table[0][(crc_state ^ (*data)) & 0xff];
+		data++;
+		data_size--;
+	}
+
+	return crc_state;
+}
+
+#if defined(__x86_64__)
+
+static uint32_t shift_crc_state(uint32_t shift_table[4][256], uint32_t crc_state)
+{
+	return shift_table[0][crc_state & 0xff] ^ shift_table[1][(crc_state >> 8) & 0xff] ^ shift_table[2][(crc_state >> 16) & 0xff] ^ shift_table[3][crc_state >> 24];
+}
+
+#define crc32c_of_word(crc_state, data)	({uint64_t word;memcpy(&word, (data), 8);(uint32_t)__builtin_ia32_crc32di((crc_state), word);})
+
+// crcs 3 adjacent blocks of block_size bytes at a time, the crcs of the 2nd and the 3rd blocks start at 0 and are combined at the end
+#define crc32c_of_3_blocks(crc_state, data, data_size, block_size, shift_table)								\
+	while((data_size) >= 3 * (block_size))																	\
+	{																										\
+		uint32_t crc0 = (crc_state), crc1 = 0, crc2 = 0;													\
+		for(const unsigned char* end = (data) + (block_size); (data) < end; (data) += 8)					\
+		{																									\
+			crc0 = crc32c_of_word(crc0, (data));															\
+			crc1 = crc32c_of_word(crc1, (data) + (block_size));												\
+			crc2 = crc32c_of_word(crc2, (data) + 2 * (block_size));											\
+		}																									\
+		(crc_state) = shift_crc_state((shift_table), shift_crc_state((shift_table), crc0) ^ crc1) ^ crc2;	\
+		(data) += 2 * (block_size);																			\
+		(data_size) -= 3 * (block_size);																	\
+	}
+
+__attribute__((target("sse4.2")))
+static uint32_t crc32c_hardware(uint32_t crc_state, const unsigned char* data, size_t data_size)
+{
+	// align the data to 8 bytes
+	while(data_size > 0 && (((uintptr_t)data) & 7))
+	{
+		crc_state = __builtin_ia32_crc32qi(crc_state, *data);
+		data++;
+		data_size--;
+	}
+
+	crc32c_of_3_blocks(crc_state, data, data_size, CRC32C_LONG_BLOCK_SIZE, crc32c_long_block_shift_table)
+	crc32c_of_3_blocks(crc_state, data, data_size, CRC32C_SHORT_BLOCK_SIZE, crc32c_short_block_shift_table)
+
+	while(data_size >= 8)
+	{
+		crc_state = crc32c_of_word(crc_state, data);
+		data += 8;
+		data_size -= 8;
+	}
+
+	while(data_size > 0)
+	{
+		crc_state = __builtin_ia32_crc32qi(crc_state, *data);
+		data++;
+		data_size--;
+	}
+
+	return crc_state;
+}
+
+int is_crc32c_hardware_accelerated()
+{
+	return __builtin_cpu_supports("sse4.2") != 0;
+}
+
+#else
+
+int is_crc32c_hardware_accelerated()
+{
+	return 0;
+}
+
+#endif
+
+uint32_t get_crc32c(uint32_t crc, const void* data, size_t data_size)
+{
+	pthread_once(&crc32c_tables_initialized, initialize_crc32c_tables);
+
+#if defined(__x86_64__)
+	if(is_crc32c_hardware_accelerated())
+		return ~crc32c_hardware(~crc, data, data_size);
+#endif
+
+	return ~crc32c_portable(~crc, data, data_size);
+}
+
+uint32_t get_crc32c_portable(uint32_t crc, const void* data, size_t data_size)
+{
+	pthread_once(&crc32c_tables_initialized, initialize_crc32c_tables);
+
+	return ~crc32c_portable(~crc, data, data_size);
+}
+
+void stamp_page_checksum(void* page, SIZE_IN_BYTES page_size)
+{
+	page_checksum_footer* footer = page + page_size - PAGE_CHECKSUM_FOOTER_SIZE;
+	footer->magic = PAGE_CHECKSUM_FOOTER_MAGIC;
+	footer->checksum = get_crc32c(0, page, page_size - sizeof(footer->checksum));
+}
+
+static int is_page_all_zeros(const void* page, SIZE_IN_BYTES page_size)
+{
+	const unsigned char* bytes = page;
+	return bytes[0] == 0 && memcmp(bytes, bytes + 1, page_size - 1) == 0;
+}
+
+int verify_page_checksum(const void* page, SIZE_IN_BYTES page_size)
+{
+	const page_checksum_footer* footer = page + page_size - PAGE_CHECKSUM_FOOTER_SIZE;
+
+	if(footer->magic == PAGE_CHECKSUM_FOOTER_MAGIC && footer->checksum == get_crc32c(0, page, page_size - sizeof(footer->checksum)))
+		return 1;
+
+	// a page without a footer is valid only if it was never written
+	return footer->magic != PAGE_CHECKSUM_FOOTER_MAGIC && is_page_all_zeros(page, page_size);
+}
\ No newline at end of file
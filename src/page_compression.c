@@ -0,0 +1,199 @@
+#include<page_compression.h>
+
+#include<lz4_codec.h>
+#include<page_checksum.h>
+
+#include<string.h>
+
+page_extent_map* get_page_extent_map(char* extent_map_file_name)
+{
+	int extent_map_fd = open(extent_map_file_name, O_RDWR | O_CREAT, S_IRUSR | S_IWUSR);
+	if(extent_map_fd == -1)
+		return NULL;
+
+	page_extent_map* pem = malloc(sizeof(page_extent_map));
+	pem->extent_map_fd = extent_map_fd;
+	pthread_mutex_init(&(pem->extent_map_lock), NULL);
+
+	struct stat extent_map_stat;
+	fstat(extent_map_fd, &extent_map_stat);
+	pem->page_ids_count = extent_map_stat.st_size / sizeof(uint16_t);
+	pem->blocks_to_read = calloc((pem->page_ids_count > 0) ? pem->page_ids_count : 1, sizeof(uint16_t));
+
+	// a partially read extent map is still usable, the entries not read are unknown (0)
+	if(pem->page_ids_count > 0)
+		pread(extent_map_fd, pem->blocks_to_read, pem->page_ids_count * sizeof(uint16_t), 0);
+
+	return pem;
+}
+
+static BLOCK_COUNT get_blocks_to_read(page_extent_map* pem, PAGE_ID page_id)
+{
+	BLOCK_COUNT blocks_to_read = 0;
+	pthread_mutex_lock(&(pem->extent_map_lock));
+		if(page_id < pem->page_ids_count)
+			blocks_to_read = pem->blocks_to_read[page_id];
+	pthread_mutex_unlock(&(pem->extent_map_lock));
+	return blocks_to_read;
+}
+
+static void set_blocks_to_read(page_extent_map* pem, PAGE_ID page_id, BLOCK_COUNT blocks_to_read)
+{
+	pthread_mutex_lock(&(pem->extent_map_lock));
+
+		if(page_id >= pem->page_ids_count)
+		{
+			// grow the map to atleast twice its size, the new entries are unknown (0)
+			PAGE_COUNT new_page_ids_count = (page_id + 1 > 2 * pem->page_ids_count) ? (page_id + 1) : (2 * pem->page_ids_count);
+			pem->blocks_to_read = realloc(pem->blocks_to_read, new_page_ids_count * sizeof(uint16_t));
+			memset(pem->blocks_to_read + pem->page_ids_count, 0, (new_page_ids_count - pem->page_ids_count) * sizeof(uint16_t));
+			pem->page_ids_count = new_page_ids_count;
+		}
+
+		// the extent map file is written only if the entry changes, which is rare once the pages have been written once
+		if(pem->blocks_to_read[page_id] != blocks_to_read)
+		{
+			pem->blocks_to_read[page_id] = blocks_to_read;
+			pwrite(pem->extent_map_fd, pem->blocks_to_read + page_id, sizeof(uint16_t), ((off_t)page_id) * sizeof(uint16_t));
+		}
+
+	pthread_mutex_unlock(&(pem->extent_map_lock));
+}
+
+// returns the number of blocks, that the compressed page at the start of page_memory spans, or 0 if page_memory does not start with a valid compressed_page_header
+static BLOCK_COUNT get_compressed_page_blocks(const void* page_memory, SIZE_IN_BYTES page_size, PAGE_ID page_id, SIZE_IN_BYTES block_size)
+{
+	const compressed_page_header* header = page_memory;
+	if(header->magic != COMPRESSED_PAGE_MAGIC || header->page_id != page_id || header->compressed_size > page_size - sizeof(compressed_page_header))
+		return 0;
+	return (sizeof(compressed_page_header) + header->compressed_size + block_size - 1) / block_size;
+}
+
+int decompress_page_in_place(void* page_memory, SIZE_IN_BYTES page_size, PAGE_ID page_id)
+{
+	if(get_compressed_page_blocks(page_memory, page_size, page_id, 1) == 0)
+		return 0;
+
+	compressed_page_header header = *((compressed_page_header*)page_memory);
+	uint32_t compressed_size = header.compressed_size;
+	if(header.checksum != get_crc32c(0, page_memory + sizeof(compressed_page_header), compressed_size))
+		return 0;
+
+	// the compressed page is moved out of the page_memory, that it is decompressed into
+	void* compressed_page = malloc(compressed_size);
+	memcpy(compressed_page, page_memory + sizeof(compressed_page_header), compressed_size);
+
+	int64_t decompressed_size = lz4_decompress(compressed_page, compressed_size, page_memory, page_size);
+
+	// on a failure, the compressed page is put back, so that the page_memory is left as it was read
+	if(decompressed_size != page_size)
+	{
+		memcpy(page_memory, &header, sizeof(compressed_page_header));
+		memcpy(page_memory + sizeof(compressed_page_header), compressed_page, compressed_size);
+	}
+
+	free(compressed_page);
+
+	return decompressed_size == page_size;
+}
+
+int write_page_compressed(page_extent_map* pem, dbfile* dbfile_p, const void* page_memory, PAGE_ID page_id, BLOCK_ID start_block_id, BLOCK_COUNT number_of_blocks, int* is_compressed)
+{
+	SIZE_IN_BYTES block_size = get_block_size(dbfile_p);
+	SIZE_IN_BYTES page_size = number_of_blocks * block_size;
+
+	(*is_compressed) = 0;
+
+	// the compressed page must fit in atleast a block lesser than the page, else it is written uncompressed
+	// the compressed page is built in a block aligned buffer, as the disk io is direct
+	void* compressed_page = NULL;
+	uint32_t compressed_size = 0;
+	if(number_of_blocks > 1 && posix_memalign(&compressed_page, block_size, page_size) == 0)
+		compressed_size = lz4_compress(page_memory, page_size, compressed_page + sizeof(compressed_page_header), page_size - block_size - sizeof(compressed_page_header));
+
+	int result;
+	BLOCK_COUNT blocks_written;
+	if(compressed_size > 0)
+	{
+		(*((compressed_page_header*)compressed_page)) = (compressed_page_header){.magic = COMPRESSED_PAGE_MAGIC, .page_id = page_id, .compressed_size = compressed_size, .checksum = get_crc32c(0, compressed_page + sizeof(compressed_page_header), compressed_size)};
+		blocks_written = (sizeof(compressed_page_header) + compressed_size + block_size - 1) / block_size;
+		memset(compressed_page + sizeof(compressed_page_header) + compressed_size, 0, blocks_written * block_size - sizeof(compressed_page_header) - compressed_size);
+
+		result = write_blocks_to_disk(dbfile_p, compressed_page, start_block_id, blocks_written);
+		if(result == blocks_written * block_size)
+		{
+			result = page_size;
+			(*is_compressed) = 1;
+		}
+	}
+	else
+	{
+		blocks_written = number_of_blocks;
+		result = write_blocks_to_disk(dbfile_p, (void*)page_memory, start_block_id, number_of_blocks);
+	}
+
+	free(compressed_page);
+
+	if(result == page_size)
+		set_blocks_to_read(pem, page_id, blocks_written);
+
+	return result;
+}
+
+int read_page_compressed(page_extent_map* pem, dbfile* dbfile_p, void* page_memory, PAGE_ID page_id, BLOCK_ID start_block_id, BLOCK_COUNT number_of_blocks, int* was_compressed)
+{
+	SIZE_IN_BYTES block_size = get_block_size(dbfile_p);
+	SIZE_IN_BYTES page_size = number_of_blocks * block_size;
+
+	(*was_compressed) = 0;
+
+	BLOCK_COUNT blocks_read = get_blocks_to_read(pem, page_id);
+	if(blocks_read == 0 || blocks_read > number_of_blocks)
+		blocks_read = number_of_blocks;
+
+	int result = read_blocks_from_disk(dbfile_p, page_memory, start_block_id, blocks_read);
+	if(result != blocks_read * block_size)
+		return result;
+
+	BLOCK_COUNT compressed_page_blocks = get_compressed_page_blocks(page_memory, page_size, page_id, block_size);
+
+	// the extent map was short of the compressed page, read the rest of it
+	if(compressed_page_blocks > blocks_read)
+	{
+		int rest_result = read_blocks_from_disk(dbfile_p, page_memory + blocks_read * block_size, start_block_id + blocks_read, compressed_page_blocks - blocks_read);
+		if(rest_result == (compressed_page_blocks - blocks_read) * block_size)
+			blocks_read = compressed_page_blocks;
+	}
+
+	if(compressed_page_blocks > 0 && compressed_page_blocks <= blocks_read && decompress_page_in_place(page_memory, page_size, page_id))
+	{
+		(*was_compressed) = 1;
+		set_blocks_to_read(pem, page_id, compressed_page_blocks);
+		return page_size;
+	}
+
+	// it is an uncompressed page, read the rest of its slot
+	if(blocks_read < number_of_blocks)
+	{
+		int rest_result = read_blocks_from_disk(dbfile_p, page_memory + blocks_read * block_size, start_block_id + blocks_read, number_of_blocks - blocks_read);
+		if(rest_result != (number_of_blocks - blocks_read) * block_size)
+			return blocks_read * block_size + ((rest_result > 0) ? rest_result : 0);
+	}
+
+	set_blocks_to_read(pem, page_id, number_of_blocks);
+	return page_size;
+}
+
+void forget_page_extent(page_extent_map* pem, PAGE_ID page_id)
+{
+	if(get_blocks_to_read(pem, page_id) != 0)
+		set_blocks_to_read(pem, page_id, 0);
+}
+
+void delete_page_extent_map(page_extent_map* pem)
+{
+	close(pem->extent_map_fd);
+	pthread_mutex_destroy(&(pem->extent_map_lock));
+	free(pem->blocks_to_read);
+	free(pem);
+}
\ No newline at end of file
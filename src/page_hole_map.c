@@ -0,0 +1,83 @@
+#include<page_hole_map.h>
+
+#include<string.h>
+
+// grows allocated_pages, to have bits for atleast page_ids_count page_ids, the new pages are holes, the caller must hold the hole_map_lock
+static void grow_page_hole_map(page_hole_map* phm, PAGE_COUNT page_ids_count)
+{
+	if(page_ids_count <= phm->page_ids_count)
+		return;
+
+	// grow to atleast twice the size, in multiples of 64 page_ids
+	PAGE_COUNT new_page_ids_count = (page_ids_count > 2 * phm->page_ids_count) ? page_ids_count : (2 * phm->page_ids_count);
+	new_page_ids_count = ((new_page_ids_count + 63) / 64) * 64;
+
+	phm->allocated_pages = realloc(phm->allocated_pages, (new_page_ids_count / 64) * sizeof(uint64_t));
+	memset(phm->allocated_pages + (phm->page_ids_count / 64), 0, ((new_page_ids_count - phm->page_ids_count) / 64) * sizeof(uint64_t));
+	phm->page_ids_count = new_page_ids_count;
+}
+
+page_hole_map* get_page_hole_map(dbfile* dbfile_p, BLOCK_COUNT number_of_blocks_per_page)
+{
+	page_hole_map* phm = malloc(sizeof(page_hole_map));
+	pthread_mutex_init(&(phm->hole_map_lock), NULL);
+	phm->allocated_pages = NULL;
+	phm->page_ids_count = 0;
+
+	// walk over all the data ranges of the heap file, and mark all the pages overlapping them as allocated
+	BLOCK_ID from_block_id = 0;
+	BLOCK_ID data_start_block_id;
+	BLOCK_ID data_end_block_id;
+	int result;
+	while((result = find_data_blocks_on_disk(dbfile_p, from_block_id, &data_start_block_id, &data_end_block_id)) == 1)
+	{
+		PAGE_ID first_page_id = data_start_block_id / number_of_blocks_per_page;
+		PAGE_ID last_page_id = (data_end_block_id - 1) / number_of_blocks_per_page;
+		grow_page_hole_map(phm, last_page_id + 1);
+		for(PAGE_ID page_id = first_page_id; page_id <= last_page_id; page_id++)
+			phm->allocated_pages[page_id / 64] |= (((uint64_t)1) << (page_id % 64));
+
+		from_block_id = data_end_block_id;
+	}
+
+	if(result == -1)
+	{
+		delete_page_hole_map(phm);
+		return NULL;
+	}
+
+	return phm;
+}
+
+int is_page_hole(page_hole_map* phm, PAGE_ID page_id)
+{
+	int is_hole = 1;
+	pthread_mutex_lock(&(phm->hole_map_lock));
+		if(page_id < phm->page_ids_count)
+			is_hole = !((phm->allocated_pages[page_id / 64] >> (page_id % 64)) & 1);
+	pthread_mutex_unlock(&(phm->hole_map_lock));
+	return is_hole;
+}
+
+void mark_page_allocated(page_hole_map* phm, PAGE_ID page_id)
+{
+	pthread_mutex_lock(&(phm->hole_map_lock));
+		grow_page_hole_map(phm, page_id + 1);
+		phm->allocated_pages[page_id / 64] |= (((uint64_t)1) << (page_id % 64));
+	pthread_mutex_unlock(&(phm->hole_map_lock));
+}
+
+void mark_page_hole(page_hole_map* phm, PAGE_ID page_id)
+{
+	pthread_mutex_lock(&(phm->hole_map_lock));
+		if(page_id < phm->page_ids_count)
+			phm->allocated_pages[page_id / 64] &= ~(((uint64_t)1) << (page_id % 64));
+	pthread_mutex_unlock(&(phm->hole_map_lock));
+}
+
+void delete_page_hole_map(page_hole_map* phm)
+{
+	pthread_mutex_destroy(&(phm->hole_map_lock));
+	free(phm->allocated_pages);
+	free(phm);
+}
\ No newline at end of file
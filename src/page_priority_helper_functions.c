@@ -5,6 +5,11 @@ int compare_page_priority(uint8_t page_priority1, uint8_t page_priority2)
 	return compare_unsigned(page_priority1, page_priority2);
 }
 
+int compare_page_request_class(uint8_t request_class1, uint8_t request_class2)
+{
+	return compare_unsigned(request_class1, request_class2);
+}
+
 void priority_queue_index_change_callback(const void* page_req, unsigned int heap_index, const void* additional_params)
 {
 	((page_request*)(page_req))->index_in_priority_queue = heap_index;
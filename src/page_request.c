@@ -1,11 +1,17 @@
 #include<page_request.h>
 
-page_request* get_page_request(PAGE_ID page_id)
+page_request* get_page_request(PAGE_ID page_id, page_request_class request_class, page_entry* frame_to_replace)
 {
 	page_request* page_req = (page_request*) malloc(sizeof(page_request));
 
 	page_req->page_id = page_id;
 	page_req->page_request_priority = 0;
+	page_req->request_class = request_class;
+	page_req->is_dispatched = 0;
+
+	page_req->frame_to_replace = frame_to_replace;
+
+	setToCurrentMonotonicTimestamp_ns(page_req->creation_timestamp_ns);
 
 	pthread_mutex_init(&(page_req->job_and_queue_bbq_lock), NULL);
 	initialize_promise(&(page_req->fulfillment_promise));
@@ -103,6 +109,38 @@ void insert_to_queue_of_waiting_bbqueues(page_request* page_req, bbqueue* bbq)
 	pthread_mutex_unlock(&(page_req->job_and_queue_bbq_lock));
 }
 
+int remove_from_queue_of_waiting_bbqueues(page_request* page_req, bbqueue* bbq)
+{
+	int removed = 0;
+
+	pthread_mutex_lock(&(page_req->job_and_queue_bbq_lock));
+
+		// the queue does not allow removal from the middle, so we rotate it once, skipping the first occurrence of the bbq
+		unsigned int bbqs_count = page_req->queue_of_waiting_bbqs.count;
+		for(unsigned int i = 0; i < bbqs_count; i++)
+		{
+			bbqueue* waiting_bbq = (bbqueue*) get_top_queue(&(page_req->queue_of_waiting_bbqs));
+			pop_queue(&(page_req->queue_of_waiting_bbqs));
+
+			if(!removed && waiting_bbq == bbq)
+				removed = 1;
+			else
+				push_queue(&(page_req->queue_of_waiting_bbqs), waiting_bbq);
+		}
+
+	pthread_mutex_unlock(&(page_req->job_and_queue_bbq_lock));
+
+	return removed;
+}
+
+int has_waiting_bbqueues(page_request* page_req)
+{
+	pthread_mutex_lock(&(page_req->job_and_queue_bbq_lock));
+		int has_waiting = !is_empty_queue(&(page_req->queue_of_waiting_bbqs));
+	pthread_mutex_unlock(&(page_req->job_and_queue_bbq_lock));
+	return has_waiting;
+}
+
 void fulfill_requested_page_entry_for_page_request(page_request* page_req, page_entry* page_ent)
 {
 	pthread_mutex_lock(&(page_req->job_and_queue_bbq_lock));
@@ -132,6 +170,13 @@ page_entry* get_requested_page_entry_and_discard_page_request(page_request* page
 {
 	page_entry* page_ent = (page_entry*) get_promised_result(&(page_req->fulfillment_promise));
 
+	release_page_request_reference(page_req);
+
+	return page_ent;
+}
+
+void release_page_request_reference(page_request* page_req)
+{
 	int should_delete_page_request = 0;
 
 	pthread_mutex_lock(&(page_req->page_request_reference_lock));
@@ -142,8 +187,6 @@ page_entry* get_requested_page_entry_and_discard_page_request(page_request* page
 
 	if(should_delete_page_request)
 		delete_page_request(page_req);
-
-	return page_ent;
 }
 
 int compare_page_request_by_page_id(const void* page_req1, const void* page_req2)
@@ -158,5 +201,12 @@ unsigned int hash_page_request_by_page_id(const void* page_req)
 
 int compare_page_request_by_page_priority(const void* page_req1, const void* page_req2)
 {
-	return compare_page_priority(((page_request*)page_req1)->page_request_priority, ((page_request*)page_req2)->page_request_priority);
+	int class_compare = compare_page_request_class(((page_request*)page_req1)->request_class, ((page_request*)page_req2)->request_class);
+	if(class_compare != 0)
+		return class_compare;
+	int priority_compare = compare_page_priority(((page_request*)page_req1)->page_request_priority, ((page_request*)page_req2)->page_request_priority);
+	if(priority_compare != 0)
+		return priority_compare;
+	// the priorities saturate at 0xff, so the ties (mostly among the saturated page_requests) are broken in favour of the older page_request (FIFO)
+	return compare_unsigned(((page_request*)page_req2)->creation_timestamp_ns, ((page_request*)page_req1)->creation_timestamp_ns);
 }
\ No newline at end of file
@@ -5,13 +5,15 @@ page_request_prioritizer* get_page_request_prioritizer(PAGE_COUNT max_requests)
 	page_request_prioritizer* prp_p = (page_request_prioritizer*) malloc(sizeof(page_request_prioritizer));
 	pthread_mutex_init(&(prp_p->page_request_priority_queue_lock), NULL);
 	initialize_heap(&(prp_p->page_request_priority_queue), max_requests, MAX_HEAP, compare_page_request_by_page_priority, priority_queue_index_change_callback, NULL);
+	prp_p->elevator_priority_band = 0;
+	prp_p->elevator_position = 0;
 	return prp_p;
 }
 
-page_request* create_and_queue_page_request(page_request_prioritizer* prp_p, PAGE_ID page_id, bufferpool* buffp)
+page_request* create_and_queue_page_request(page_request_prioritizer* prp_p, PAGE_ID page_id, page_request_class request_class, page_entry* frame_to_replace, bufferpool* buffp)
 {
 	// create a new page request
-	page_request* page_req = get_page_request(page_id);
+	page_request* page_req = get_page_request(page_id, request_class, frame_to_replace);
 
 	pthread_mutex_lock(&(prp_p->page_request_priority_queue_lock));
 
@@ -32,22 +34,93 @@ page_request* create_and_queue_page_request(page_request_prioritizer* prp_p, PAG
 	return page_req;
 }
 
-void increment_priority_for_page_request(page_request_prioritizer* prp_p, page_request* page_req)
+void increment_priority_for_page_request(page_request_prioritizer* prp_p, page_request* page_req, page_request_class request_class)
 {
 	pthread_mutex_lock(&(prp_p->page_request_priority_queue_lock));
-		if(increment_page_request_priority(page_req))
-			heapify_at(&(prp_p->page_request_priority_queue), page_req->index_in_priority_queue);
+		if(!page_req->is_dispatched)
+		{
+			int is_class_upgraded = 0;
+			if(page_req->request_class < request_class)
+			{
+				page_req->request_class = request_class;
+				is_class_upgraded = 1;
+			}
+			if(increment_page_request_priority(page_req) || is_class_upgraded)
+				heapify_at(&(prp_p->page_request_priority_queue), page_req->index_in_priority_queue);
+		}
 	pthread_mutex_unlock(&(prp_p->page_request_priority_queue_lock));
 }
 
+int remove_page_request_if_not_dispatched(page_request_prioritizer* prp_p, page_request* page_req)
+{
+	int removed = 0;
+	pthread_mutex_lock(&(prp_p->page_request_priority_queue_lock));
+		if(!page_req->is_dispatched)
+			removed = remove_at_index_heap(&(prp_p->page_request_priority_queue), page_req->index_in_priority_queue);
+	pthread_mutex_unlock(&(prp_p->page_request_priority_queue_lock));
+	return removed;
+}
+
+typedef struct elevator_search elevator_search;
+struct elevator_search
+{
+	// only the page_requests of this class, and with atleast this priority, are considered
+	page_request_class request_class;
+	uint8_t min_priority;
+
+	// the elevator position
+	PAGE_ID position;
+
+	// the considered page_request with the lowest page_id at or after the position
+	page_request* next_in_sweep;
+
+	// the considered page_request with the lowest page_id, the sweep wraps around to it, if there is no next_in_sweep
+	page_request* lowest;
+};
+
+static void find_next_for_elevator(void* page_req_v, unsigned int heap_index, const void* additional_params)
+{
+	page_request* page_req = page_req_v;
+	elevator_search* es = (elevator_search*) additional_params;
+
+	if(page_req->request_class != es->request_class || page_req->page_request_priority < es->min_priority)
+		return;
+
+	if(page_req->page_id >= es->position && (es->next_in_sweep == NULL || page_req->page_id < es->next_in_sweep->page_id))
+		es->next_in_sweep = page_req;
+
+	if(es->lowest == NULL || page_req->page_id < es->lowest->page_id)
+		es->lowest = page_req;
+}
+
 page_request* get_highest_priority_page_request_to_fulfill(page_request_prioritizer* prp_p)
 {
 	pthread_mutex_lock(&(prp_p->page_request_priority_queue_lock));
 		
-		// pop the highest priority page request from the page prioritizer's heap
+		// the highest priority page request from the page prioritizer's heap
 		page_request* page_req = (page_request*)get_top_heap(&(prp_p->page_request_priority_queue));
+
+		// pick the next page_request in the elevator sweep, from the page_requests in the band of the highest priority one
+		// unless the highest priority one has a saturated priority (0xff), the saturated page_requests can not be told apart by their priorities, so they are dispatched in the FIFO order of the heap
+		if(page_req != NULL && prp_p->elevator_priority_band > 0 && page_req->page_request_priority != 0xff && get_element_count_heap(&(prp_p->page_request_priority_queue)) > 1)
+		{
+			elevator_search es = {
+				.request_class = page_req->request_class,
+				.min_priority = (page_req->page_request_priority > prp_p->elevator_priority_band) ? (page_req->page_request_priority - prp_p->elevator_priority_band) : 0,
+				.position = prp_p->elevator_position,
+				.next_in_sweep = NULL,
+				.lowest = NULL,
+			};
+			for_each_in_heap(&(prp_p->page_request_priority_queue), find_next_for_elevator, &es);
+			page_req = (es.next_in_sweep != NULL) ? es.next_in_sweep : es.lowest;
+		}
+
 		if(page_req != NULL)
-			pop_heap(&(prp_p->page_request_priority_queue));
+		{
+			remove_at_index_heap(&(prp_p->page_request_priority_queue), page_req->index_in_priority_queue);
+			page_req->is_dispatched = 1;
+			prp_p->elevator_position = page_req->page_id + 1;
+		}
 
 		// if the heap is considerably large, then shrink it
 		if(get_total_size_heap(&(prp_p->page_request_priority_queue)) > 3 * get_element_count_heap(&(prp_p->page_request_priority_queue)))
@@ -56,6 +129,13 @@ page_request* get_highest_priority_page_request_to_fulfill(page_request_prioriti
 	return page_req;
 }
 
+void set_elevator_priority_band(page_request_prioritizer* prp_p, uint8_t elevator_priority_band)
+{
+	pthread_mutex_lock(&(prp_p->page_request_priority_queue_lock));
+		prp_p->elevator_priority_band = elevator_priority_band;
+	pthread_mutex_unlock(&(prp_p->page_request_priority_queue_lock));
+}
+
 void delete_page_request_prioritizer(page_request_prioritizer* prp_p)
 {
 	pthread_mutex_destroy(&(prp_p->page_request_priority_queue_lock));
@@ -12,7 +12,7 @@ page_request_tracker* get_page_request_tracker(PAGE_COUNT max_requests)
 	return prt_p;
 }
 
-page_request* find_or_create_request_for_page_id(page_request_tracker* prt_p, PAGE_ID page_id, bufferpool* buffp, bbqueue* bbq, page_entry** existing_page_entry)
+page_request* find_or_create_request_for_page_id(page_request_tracker* prt_p, PAGE_ID page_id, page_request_class request_class, bufferpool* buffp, bbqueue* bbq, page_entry* frame_to_replace, page_entry** existing_page_entry)
 {
 	// dummy page_request with given page_id to call search
 	page_request dummy_page_request = {.page_id = page_id};
@@ -28,7 +28,8 @@ page_request* find_or_create_request_for_page_id(page_request_tracker* prt_p, PA
 		// and increment its reference count before returning it
 		if(page_req != NULL)
 		{
-			increment_priority_for_page_request(buffp->rq_prioritizer, page_req);
+			increment_priority_for_page_request(buffp->rq_prioritizer, page_req, request_class);
+			increment_stat(buffp->stats, page_requests_piggybacked);
 
 			// if we have to share the reference of the page_request with the callee, 
 			// we must increment the reference count of the page_request
@@ -61,7 +62,8 @@ page_request* find_or_create_request_for_page_id(page_request_tracker* prt_p, PA
 			{
 				// if not found, create a new page request, queue it to be fulfilled 
 				// and then insert it to the page_request_tracker hashmap so other requesters can easily find it
-				page_req = create_and_queue_page_request(buffp->rq_prioritizer, page_id, buffp);
+				page_req = create_and_queue_page_request(buffp->rq_prioritizer, page_id, request_class, frame_to_replace, buffp);
+				increment_stat(buffp->stats, page_requests_created);
 
 				// insert page_req to page_request_tracker hashmap
 				// prior to insertion; expand hashmap if necessary
@@ -70,7 +72,10 @@ page_request* find_or_create_request_for_page_id(page_request_tracker* prt_p, PA
 				insert_in_hashmap(&(prt_p->page_request_map), page_req);
 			}
 			else // if a page_request is found, just increment its priority inorder to prioritize it
-				increment_priority_for_page_request(buffp->rq_prioritizer, page_req);
+			{
+				increment_priority_for_page_request(buffp->rq_prioritizer, page_req, request_class);
+				increment_stat(buffp->stats, page_requests_piggybacked);
+			}
 
 			// if we have to share the reference of the page_request with the callee, 
 			// we must increment the reference count of the page_request
@@ -114,6 +119,33 @@ int discard_page_request(page_request_tracker* prt_p, PAGE_ID page_id)
 	return discarded;
 }
 
+int cancel_page_request_for_bbqueue(page_request_tracker* prt_p, PAGE_ID page_id, bufferpool* buffp, bbqueue* bbq)
+{
+	// dummy page_request to call search on
+	page_request dummy_page_request = {.page_id = page_id};
+
+	int cancelled = 0;
+
+	// the write lock ensures that no one can start waiting on the page_request, while we check if anyone is waiting on it
+	write_lock(&(prt_p->page_request_tracker_lock));
+		page_request* page_req = (page_request*) find_equals_in_hashmap(&(prt_p->page_request_map), &dummy_page_request);
+		if(page_req != NULL && remove_from_queue_of_waiting_bbqueues(page_req, bbq))
+		{
+			cancelled = 1;
+
+			// the only reference to an unwanted page_request is the one held by the page_request_tracker
+			if(!has_waiting_bbqueues(page_req) && get_page_request_reference_count(page_req) == 1
+				&& remove_page_request_if_not_dispatched(buffp->rq_prioritizer, page_req))
+			{
+				remove_from_hashmap(&(prt_p->page_request_map), page_req);
+				mark_page_request_for_deletion(page_req);
+			}
+		}
+	write_unlock(&(prt_p->page_request_tracker_lock));
+
+	return cancelled;
+}
+
 static void delete_page_requests_wrapper(const void* page_req, const void* additional_params)
 {
 	mark_page_request_for_deletion((page_request*)page_req);
@@ -0,0 +1,133 @@
+#include<read_ahead_detector.h>
+
+#include<stdlib.h>
+
+read_ahead_detector* get_read_ahead_detector(PAGE_COUNT max_window)
+{
+	read_ahead_detector* rad_p = (read_ahead_detector*) malloc(sizeof(read_ahead_detector));
+	pthread_mutex_init(&(rad_p->read_ahead_lock), NULL);
+	rad_p->max_window = max_window;
+	rad_p->access_tick = 0;
+	for(int i = 0; i < READ_AHEAD_STREAMS_COUNT; i++)
+	{
+		read_ahead_stream* stream = rad_p->streams + i;
+		stream->next_expected_page_id = 0;
+		stream->read_ahead_upto_page_id = 0;
+		stream->trigger_page_id = 0;
+		stream->has_trigger = 0;
+		stream->sequential_count = 0;
+		stream->window = 0;
+		stream->last_access_tick = 0;
+	}
+	return rad_p;
+}
+
+int is_read_ahead_trigger(read_ahead_detector* rad_p, PAGE_ID page_id)
+{
+	for(int i = 0; i < READ_AHEAD_STREAMS_COUNT; i++)
+	{
+		read_ahead_stream* stream = rad_p->streams + i;
+		if(__atomic_load_n(&(stream->has_trigger), __ATOMIC_RELAXED) && __atomic_load_n(&(stream->trigger_page_id), __ATOMIC_RELAXED) == page_id)
+			return 1;
+	}
+	return 0;
+}
+
+static void set_trigger(read_ahead_stream* stream, PAGE_ID trigger_page_id)
+{
+	__atomic_store_n(&(stream->trigger_page_id), trigger_page_id, __ATOMIC_RELAXED);
+	__atomic_store_n(&(stream->has_trigger), 1, __ATOMIC_RELAXED);
+}
+
+static void clear_trigger(read_ahead_stream* stream)
+{
+	__atomic_store_n(&(stream->has_trigger), 0, __ATOMIC_RELAXED);
+}
+
+// reads ahead the next window of the stream, and makes its first page the new trigger page
+static PAGE_COUNT read_ahead_next_window(read_ahead_detector* rad_p, read_ahead_stream* stream, PAGE_ID page_id, PAGE_ID* read_ahead_start_page_id)
+{
+	// never read ahead, the pages that are already read ahead
+	PAGE_ID start_page_id = page_id + 1;
+	if(start_page_id < stream->read_ahead_upto_page_id)
+		start_page_id = stream->read_ahead_upto_page_id;
+
+	PAGE_COUNT window = stream->window;
+
+	// the window grows with every read ahead, untill it reaches the max_window
+	stream->window = (stream->window * 2 > rad_p->max_window) ? rad_p->max_window : stream->window * 2;
+
+	stream->read_ahead_upto_page_id = start_page_id + window;
+	set_trigger(stream, start_page_id);
+
+	*read_ahead_start_page_id = start_page_id;
+	return window;
+}
+
+PAGE_COUNT register_page_access_for_read_ahead(read_ahead_detector* rad_p, PAGE_ID page_id, int is_miss, PAGE_ID* read_ahead_start_page_id)
+{
+	PAGE_COUNT read_ahead_page_count = 0;
+
+	pthread_mutex_lock(&(rad_p->read_ahead_lock));
+
+		rad_p->access_tick++;
+
+		read_ahead_stream* stream = NULL;
+		read_ahead_stream* least_recently_used_stream = rad_p->streams;
+
+		for(int i = 0; i < READ_AHEAD_STREAMS_COUNT; i++)
+		{
+			read_ahead_stream* s = rad_p->streams + i;
+
+			// an access continues a stream, if it is the trigger page of the stream, or if it is the next page that the stream is expected to miss
+			if((s->has_trigger && s->trigger_page_id == page_id) || (s->sequential_count > 0 && s->next_expected_page_id == page_id))
+			{
+				stream = s;
+				break;
+			}
+
+			if(s->last_access_tick < least_recently_used_stream->last_access_tick)
+				least_recently_used_stream = s;
+		}
+
+		if(stream != NULL)
+		{
+			stream->last_access_tick = rad_p->access_tick;
+			stream->next_expected_page_id = page_id + 1;
+
+			if(stream->has_trigger && stream->trigger_page_id == page_id)
+			{
+				// the stream has consumed upto its trigger page, read ahead its next window
+				clear_trigger(stream);
+				read_ahead_page_count = read_ahead_next_window(rad_p, stream, page_id, read_ahead_start_page_id);
+			}
+			else if(is_miss)
+			{
+				// a stream missing its consecutive pages is sequential, start reading ahead
+				stream->sequential_count++;
+				if(stream->sequential_count >= 2 && page_id + 1 >= stream->read_ahead_upto_page_id)
+					read_ahead_page_count = read_ahead_next_window(rad_p, stream, page_id, read_ahead_start_page_id);
+			}
+		}
+		else if(is_miss)
+		{
+			// the page does not continue any stream, so it starts a new stream replacing the least recently used stream
+			stream = least_recently_used_stream;
+			clear_trigger(stream);
+			stream->next_expected_page_id = page_id + 1;
+			stream->read_ahead_upto_page_id = page_id + 1;
+			stream->sequential_count = 1;
+			stream->window = (INITIAL_READ_AHEAD_WINDOW > rad_p->max_window) ? rad_p->max_window : INITIAL_READ_AHEAD_WINDOW;
+			stream->last_access_tick = rad_p->access_tick;
+		}
+
+	pthread_mutex_unlock(&(rad_p->read_ahead_lock));
+
+	return read_ahead_page_count;
+}
+
+void delete_read_ahead_detector(read_ahead_detector* rad_p)
+{
+	pthread_mutex_destroy(&(rad_p->read_ahead_lock));
+	free(rad_p);
+}
\ No newline at end of file
@@ -0,0 +1,140 @@
+#include<scan_ring.h>
+
+#include<bufferpool.h>
+#include<bufferpool_struct_def.h>
+
+scan_ring* get_scan_ring(bufferpool* buffp, PAGE_COUNT ring_size)
+{
+	// a scan must not be allowed to hold a considerable part of the bufferpool in its ring
+	PAGE_COUNT max_ring_size = buffp->pages_in_bufferpool / 4;
+	if(ring_size > max_ring_size)
+		ring_size = max_ring_size;
+	if(ring_size == 0)
+		ring_size = 1;
+
+	scan_ring* ring = (scan_ring*) malloc(sizeof(scan_ring) + (sizeof(scan_ring_slot) * ring_size));
+	pthread_mutex_init(&(ring->scan_ring_lock), NULL);
+	ring->ring_size = ring_size;
+	ring->frames_in_ring = 0;
+	ring->next_frame_to_recycle = 0;
+	ring->last_recycled_frame = 0;
+	return ring;
+}
+
+// returns the index of the slot of page_ent, or frames_in_ring if page_ent is not in the ring, the ring lock must be held by the caller
+static PAGE_COUNT find_slot_in_scan_ring_unsafe(scan_ring* ring, page_entry* page_ent)
+{
+	PAGE_COUNT i = 0;
+	while(i < ring->frames_in_ring && ring->slots[i].frame != page_ent)
+		i++;
+	return i;
+}
+
+// removes the slot at index i, by moving the last slot of the ring in to it, the ring lock must be held by the caller
+static void remove_slot_from_scan_ring_unsafe(scan_ring* ring, PAGE_COUNT i)
+{
+	ring->slots[i] = ring->slots[--ring->frames_in_ring];
+	if(ring->next_frame_to_recycle >= ring->frames_in_ring)
+		ring->next_frame_to_recycle = 0;
+}
+
+page_entry* get_frame_to_recycle(bufferpool* buffp, scan_ring* ring)
+{
+	scan_ring_slot slot = {.frame = NULL};
+	pthread_mutex_lock(&(ring->scan_ring_lock));
+		if(ring->frames_in_ring == ring->ring_size)
+			slot = ring->slots[ring->next_frame_to_recycle];
+	pthread_mutex_unlock(&(ring->scan_ring_lock));
+
+	if(slot.frame == NULL)
+		return NULL;
+
+	// the ring lock is never held while taking the page_entry_lock, (the release of a page takes them in the opposite order)
+	pthread_mutex_lock(&(slot.frame->page_entry_lock));
+		int is_owned_by_ring = (slot.frame->page_id == slot.page_id) && check(slot.frame, IS_VALID) && !is_page_entry_present_in_lru(buffp->lru_p, slot.frame);
+	pthread_mutex_unlock(&(slot.frame->page_entry_lock));
+
+	page_entry* page_ent = NULL;
+	int is_removed_from_ring = 0;
+	pthread_mutex_lock(&(ring->scan_ring_lock));
+		// the slots may have moved, while we did not hold the ring lock
+		PAGE_COUNT i = find_slot_in_scan_ring_unsafe(ring, slot.frame);
+		if(i < ring->frames_in_ring)
+		{
+			if(is_owned_by_ring && ring->frames_in_ring == ring->ring_size)
+			{
+				page_ent = slot.frame;
+				ring->last_recycled_frame = i;
+				ring->next_frame_to_recycle = (i + 1) % ring->ring_size;
+			}
+			else if(!is_owned_by_ring)
+			{
+				// the frame is part of the working set (or holds some other page) now, it is left to the lru
+				remove_slot_from_scan_ring_unsafe(ring, i);
+				is_removed_from_ring = 1;
+			}
+		}
+	pthread_mutex_unlock(&(ring->scan_ring_lock));
+
+	// a frame dropped from the ring, that is neither pinned nor in the lru, must not be left orphaned
+	if(is_removed_from_ring)
+		return_frame_to_lru(buffp, slot.frame);
+
+	return page_ent;
+}
+
+static int is_frame_in_scan_ring_unsafe(scan_ring* ring, page_entry* page_ent)
+{
+	return find_slot_in_scan_ring_unsafe(ring, page_ent) < ring->frames_in_ring;
+}
+
+int is_frame_in_scan_ring(scan_ring* ring, page_entry* page_ent)
+{
+	pthread_mutex_lock(&(ring->scan_ring_lock));
+		int result = is_frame_in_scan_ring_unsafe(ring, page_ent);
+	pthread_mutex_unlock(&(ring->scan_ring_lock));
+	return result;
+}
+
+page_entry* adopt_frame_in_scan_ring(scan_ring* ring, page_entry* page_ent)
+{
+	page_entry* dropped_frame = NULL;
+	pthread_mutex_lock(&(ring->scan_ring_lock));
+		scan_ring_slot slot = {.frame = page_ent, .page_id = page_ent->page_id};
+		PAGE_COUNT i = find_slot_in_scan_ring_unsafe(ring, page_ent);
+		if(i < ring->frames_in_ring)
+		{
+			// a recycled frame, it now holds the page that the scan just missed
+			ring->slots[i].page_id = slot.page_id;
+		}
+		else
+		{
+			if(ring->frames_in_ring < ring->ring_size)
+				ring->slots[ring->frames_in_ring++] = slot;
+			else
+			{
+				dropped_frame = ring->slots[ring->last_recycled_frame].frame;
+				ring->slots[ring->last_recycled_frame] = slot;
+			}
+		}
+	pthread_mutex_unlock(&(ring->scan_ring_lock));
+	return dropped_frame;
+}
+
+void return_frame_to_lru(bufferpool* buffp, page_entry* page_ent)
+{
+	pthread_mutex_lock(&(page_ent->page_entry_lock));
+		if(page_ent->pinned_by_count == 0 && !is_page_entry_present_in_lru(buffp->lru_p, page_ent))
+			mark_as_evictable(buffp->lru_p, page_ent);
+	pthread_mutex_unlock(&(page_ent->page_entry_lock));
+}
+
+void delete_scan_ring(bufferpool* buffp, scan_ring* ring)
+{
+	// all the frames of the ring go back in circulation
+	for(PAGE_COUNT i = 0; i < ring->frames_in_ring; i++)
+		return_frame_to_lru(buffp, ring->slots[i].frame);
+
+	pthread_mutex_destroy(&(ring->scan_ring_lock));
+	free(ring);
+}
\ No newline at end of file
@@ -0,0 +1,218 @@
+#include<shared_scan_coordinator.h>
+
+#include<bufferpool.h>
+#include<bufferpool_struct_def.h>
+
+#include<stddef.h>
+#include<string.h>
+
+shared_scan_coordinator* get_shared_scan_coordinator()
+{
+	shared_scan_coordinator* ssc_p = (shared_scan_coordinator*) malloc(sizeof(shared_scan_coordinator));
+	pthread_mutex_init(&(ssc_p->coordinator_lock), NULL);
+	initialize_linkedlist(&(ssc_p->scan_groups), offsetof(scan_group, scan_groups_ll_node));
+	return ssc_p;
+}
+
+static int is_page_requested_for_shared_scan(shared_scan* sscan, PAGE_COUNT page_offset)
+{
+	return (sscan->pages_requested_bitmap[page_offset / 8] >> (page_offset % 8)) & 1;
+}
+
+static void set_page_requested_for_shared_scan(shared_scan* sscan, PAGE_COUNT page_offset)
+{
+	sscan->pages_requested_bitmap[page_offset / 8] |= (1 << (page_offset % 8));
+}
+
+typedef struct advance_params advance_params;
+struct advance_params
+{
+	bufferpool* buffp;
+	PAGE_COUNT page_offset;
+
+	// set if some shared_scan needs the page at page_offset, but does not have space in its window for it
+	int is_any_shared_scan_lagging;
+};
+
+static int has_space_in_window(shared_scan* sscan)
+{
+	return (sscan->pages_requested - sscan->pages_consumed) < sscan->window_size;
+}
+
+static void check_if_shared_scan_lags(const void* sscan_p, const void* additional_params)
+{
+	shared_scan* sscan = (shared_scan*) sscan_p;
+	advance_params* params = (advance_params*) additional_params;
+
+	if(!is_page_requested_for_shared_scan(sscan, params->page_offset) && !has_space_in_window(sscan))
+		params->is_any_shared_scan_lagging = 1;
+}
+
+static void request_page_for_shared_scan_if_required(const void* sscan_p, const void* additional_params)
+{
+	shared_scan* sscan = (shared_scan*) sscan_p;
+	const advance_params* params = additional_params;
+
+	// the page is requested for the scan, only if it has not already received it and has space in its window (and its bbq)
+	if(!is_page_requested_for_shared_scan(sscan, params->page_offset) && has_space_in_window(sscan))
+	{
+		set_page_requested_for_shared_scan(sscan, params->page_offset);
+		sscan->pages_requested++;
+
+		// the page_requests piggy-back, so the page is read from disk only once for all the shared_scans requesting it
+		request_page_prefetch(params->buffp, sscan->group->start_page_id + params->page_offset, 1, sscan->bbq);
+	}
+}
+
+// moves the cursor of the group forward, requesting pages for all its shared_scans, untill the window of the given shared_scan is full
+// or untill the given shared_scan has requested all the pages of the range
+// the cursor waits for the lagging shared_scans (the ones without space in their windows), to keep all the scans of the group in step,
+// unless the given shared_scan has no pages left to consume, in which case the lagging shared_scans miss the page, and get it after the cursor wraps around
+// it must be called with the coordinator_lock held
+static void advance_scan_group(bufferpool* buffp, scan_group* group, shared_scan* sscan)
+{
+	// the cursor needs to go around the range atmost once, to fill the window of the given shared_scan
+	for(PAGE_COUNT steps = 0; steps < group->page_count; steps++)
+	{
+		if(sscan->pages_requested == group->page_count || !has_space_in_window(sscan))
+			break;
+
+		advance_params params = {.buffp = buffp, .page_offset = group->next_page_offset, .is_any_shared_scan_lagging = 0};
+
+		for_each_in_linkedlist(&(group->shared_scans), check_if_shared_scan_lags, &params);
+		if(params.is_any_shared_scan_lagging && sscan->pages_requested > sscan->pages_consumed)
+			break;
+
+		for_each_in_linkedlist(&(group->shared_scans), request_page_for_shared_scan_if_required, &params);
+
+		group->next_page_offset = (group->next_page_offset + 1) % group->page_count;
+	}
+}
+
+typedef struct group_range group_range;
+struct group_range
+{
+	PAGE_ID start_page_id;
+	PAGE_COUNT page_count;
+	scan_group* group_found;
+};
+
+static void find_scan_group_for_range(const void* group_p, const void* additional_params)
+{
+	scan_group* group = (scan_group*) group_p;
+	group_range* range = (group_range*) additional_params;
+	if(group->start_page_id == range->start_page_id && group->page_count == range->page_count)
+		range->group_found = group;
+}
+
+shared_scan* join_shared_scan(bufferpool* buffp, PAGE_ID start_page_id, PAGE_COUNT page_count, PAGE_COUNT window_size)
+{
+	if(page_count == 0)
+		return NULL;
+
+	// the window can not be larger than what the bbq can hold
+	if(window_size == 0)
+		window_size = 1;
+
+	shared_scan_coordinator* ssc_p = buffp->scan_coordinator;
+
+	shared_scan* sscan = (shared_scan*) malloc(sizeof(shared_scan));
+	sscan->bbq = get_bbqueue(window_size);
+	sscan->window_size = window_size;
+	sscan->pages_requested = 0;
+	sscan->pages_consumed = 0;
+	sscan->pages_requested_bitmap = (uint8_t*) calloc((page_count / 8) + 1, sizeof(uint8_t));
+	initialize_llnode(&(sscan->shared_scans_ll_node));
+
+	pthread_mutex_lock(&(ssc_p->coordinator_lock));
+
+		// find the scan_group scanning the same range, if there isn't any, this shared_scan starts one
+		group_range range = {.start_page_id = start_page_id, .page_count = page_count, .group_found = NULL};
+		for_each_in_linkedlist(&(ssc_p->scan_groups), find_scan_group_for_range, &range);
+
+		scan_group* group = range.group_found;
+		if(group == NULL)
+		{
+			group = (scan_group*) malloc(sizeof(scan_group));
+			group->start_page_id = start_page_id;
+			group->page_count = page_count;
+			group->next_page_offset = 0;
+			initialize_linkedlist(&(group->shared_scans), offsetof(shared_scan, shared_scans_ll_node));
+			initialize_llnode(&(group->scan_groups_ll_node));
+			insert_tail(&(ssc_p->scan_groups), group);
+		}
+
+		sscan->group = group;
+		insert_tail(&(group->shared_scans), sscan);
+
+	pthread_mutex_unlock(&(ssc_p->coordinator_lock));
+
+	return sscan;
+}
+
+int get_next_page_of_shared_scan(bufferpool* buffp, shared_scan* sscan, PAGE_ID* page_id)
+{
+	shared_scan_coordinator* ssc_p = buffp->scan_coordinator;
+
+	pthread_mutex_lock(&(ssc_p->coordinator_lock));
+
+		if(sscan->pages_consumed == sscan->group->page_count)
+		{
+			pthread_mutex_unlock(&(ssc_p->coordinator_lock));
+			return 0;
+		}
+
+		// keep the io ahead of the consumption, by advancing the group once half of the window is consumed
+		if((sscan->pages_requested - sscan->pages_consumed) <= (sscan->window_size / 2))
+			advance_scan_group(buffp, sscan->group, sscan);
+
+	pthread_mutex_unlock(&(ssc_p->coordinator_lock));
+
+	// there is atleast one page requested for this scan, that is yet to be consumed, so this pop will not block forever
+	*page_id = pop_bbqueue(sscan->bbq);
+
+	pthread_mutex_lock(&(ssc_p->coordinator_lock));
+		sscan->pages_consumed++;
+	pthread_mutex_unlock(&(ssc_p->coordinator_lock));
+
+	return 1;
+}
+
+void leave_shared_scan(bufferpool* buffp, shared_scan* sscan)
+{
+	shared_scan_coordinator* ssc_p = buffp->scan_coordinator;
+
+	pthread_mutex_lock(&(ssc_p->coordinator_lock));
+
+		scan_group* group = sscan->group;
+		remove_from_linkedlist(&(group->shared_scans), sscan);
+
+		// the last shared_scan to leave, deletes the scan_group
+		if(is_empty_linkedlist(&(group->shared_scans)))
+		{
+			remove_from_linkedlist(&(ssc_p->scan_groups), group);
+			free(group);
+		}
+
+		PAGE_COUNT pages_outstanding = sscan->pages_requested - sscan->pages_consumed;
+
+	pthread_mutex_unlock(&(ssc_p->coordinator_lock));
+
+	// the pages already requested for this scan will still be pushed to its bbq by the io_dispatcher
+	// so we wait for all of them to arrive, before the bbq can be deleted
+	while(pages_outstanding > 0)
+	{
+		pop_bbqueue(sscan->bbq);
+		pages_outstanding--;
+	}
+
+	delete_bbqueue(sscan->bbq);
+	free(sscan->pages_requested_bitmap);
+	free(sscan);
+}
+
+void delete_shared_scan_coordinator(shared_scan_coordinator* ssc_p)
+{
+	pthread_mutex_destroy(&(ssc_p->coordinator_lock));
+	free(ssc_p);
+}
\ No newline at end of file
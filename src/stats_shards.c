@@ -0,0 +1,49 @@
+#include<stats_shards.h>
+
+#include<string.h>
+
+// the shard index of the calling thread, it is the same for all the bufferpools
+// STATS_SHARDS_COUNT means that the thread is not yet assigned a shard
+static __thread unsigned int shard_index_of_this_thread = STATS_SHARDS_COUNT;
+
+static unsigned int next_shard_index = 0;
+
+stats_shards* get_stats_shards()
+{
+	stats_shards* ss_p = (stats_shards*) aligned_alloc(CACHE_LINE_SIZE, sizeof(stats_shards));
+	memset(ss_p, 0, sizeof(stats_shards));
+	return ss_p;
+}
+
+stats_shard* get_stats_shard_for_this_thread(stats_shards* ss_p)
+{
+	if(shard_index_of_this_thread == STATS_SHARDS_COUNT)
+		shard_index_of_this_thread = __atomic_fetch_add(&next_shard_index, 1, __ATOMIC_RELAXED) % STATS_SHARDS_COUNT;
+	return ss_p->shards + shard_index_of_this_thread;
+}
+
+void aggregate_stats_shards(stats_shards* ss_p, bufferpool_stats* stats)
+{
+	memset(stats, 0, sizeof(bufferpool_stats));
+
+	// bufferpool_stats is only a set of uint64_t counters, so it can be summed up counter by counter
+	uint64_t* total = (uint64_t*) stats;
+	for(int s = 0; s < STATS_SHARDS_COUNT; s++)
+	{
+		uint64_t* counters = (uint64_t*) (&(ss_p->shards[s].counters));
+		for(size_t i = 0; i < sizeof(bufferpool_stats) / sizeof(uint64_t); i++)
+			total[i] += __atomic_load_n(counters + i, __ATOMIC_RELAXED);
+	}
+}
+
+void aggregate_latency_histograms_of_stats_shards(stats_shards* ss_p, bufferpool_latency latency, latency_histogram* hist)
+{
+	initialize_latency_histogram(hist);
+	for(int s = 0; s < STATS_SHARDS_COUNT; s++)
+		merge_latency_histogram(hist, &(ss_p->shards[s].latencies[latency]));
+}
+
+void delete_stats_shards(stats_shards* ss_p)
+{
+	free(ss_p);
+}
\ No newline at end of file
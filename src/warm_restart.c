@@ -0,0 +1,213 @@
+#include<warm_restart.h>
+
+#include<bufferpool_struct_def.h>
+
+#include<page_checksum.h>
+
+#include<sys/mman.h>
+
+typedef struct resident_pages_collector resident_pages_collector;
+struct resident_pages_collector
+{
+	resident_page_entry* entries;
+	uint32_t entries_count;
+	uint32_t entries_capacity;
+};
+
+static void collect_resident_page(const void* page_ent_v, const void* additional_params)
+{
+	page_entry* page_ent = (page_entry*) page_ent_v;
+	resident_pages_collector* rpc = (resident_pages_collector*) additional_params;
+
+	if(check(page_ent, IS_VALID) && rpc->entries_count < rpc->entries_capacity)
+		rpc->entries[rpc->entries_count++] = (resident_page_entry){.page_id = page_ent->page_id, .usage_count = page_ent->usage_count};
+}
+
+int write_resident_pages_dump(bufferpool* buffp, char* dump_file_name)
+{
+	FILE* dump_file = fopen(dump_file_name, "wb");
+	if(dump_file == NULL)
+		return 0;
+
+	resident_pages_collector rpc = {
+		.entries = malloc(sizeof(resident_page_entry) * buffp->pages_in_bufferpool),
+		.entries_count = 0,
+		.entries_capacity = buffp->pages_in_bufferpool,
+	};
+
+	// the pages in the lru, from the least to the most recently used
+	for_each_used_page_entry_in_lru(buffp->lru_p, collect_resident_page, &rpc);
+
+	// followed by the pages not in the lru, that are pinned or are yet to be used
+	// a page_entry that moves in to the lru after we walked it, may be listed twice, the duplicate entries are ignored while loading
+	for(PAGE_COUNT i = 0; i < buffp->pages_in_bufferpool; i++)
+	{
+		page_entry* page_ent = buffp->page_entries + i;
+		pthread_mutex_lock(&(page_ent->page_entry_lock));
+			if(!is_page_entry_present_in_lru(buffp->lru_p, page_ent))
+				collect_resident_page(page_ent, &rpc);
+		pthread_mutex_unlock(&(page_ent->page_entry_lock));
+	}
+
+	resident_pages_dump_header header = {
+		.magic = RESIDENT_PAGES_DUMP_MAGIC,
+		.version = RESIDENT_PAGES_DUMP_VERSION,
+		.page_size = buffp->number_of_blocks_per_page * get_block_size(buffp->db_file),
+		.entries_count = rpc.entries_count,
+	};
+
+	int written = (fwrite(&header, sizeof(header), 1, dump_file) == 1)
+				&& (fwrite(rpc.entries, sizeof(resident_page_entry), rpc.entries_count, dump_file) == rpc.entries_count);
+
+	written = (fclose(dump_file) == 0) && written;
+
+	free(rpc.entries);
+
+	return written;
+}
+
+static int compare_resident_page_entries_by_page_id(const void* e1, const void* e2)
+{
+	return compare_unsigned(((const resident_page_entry*)e1)->page_id, ((const resident_page_entry*)e2)->page_id);
+}
+
+// brings the page, whose contents are at page_memory, in to a free frame of the bufferpool
+// returns 0, if the page is already in the bufferpool, or if there are no free frames left
+static int install_warm_page(bufferpool* buffp, PAGE_ID page_id, uint32_t usage_count, void* page_memory, SIZE_IN_BYTES page_size, int* no_free_frames)
+{
+	if(find_page_entry_by_page_id(buffp->pg_tbl, page_id) != NULL)
+		return 0;
+
+	page_entry* page_ent = get_swapable_page(buffp->lru_p);
+
+	// only the free frames are used, we never evict a page to warm up the bufferpool
+	if(page_ent == NULL || check(page_ent, IS_VALID))
+	{
+		if(page_ent != NULL)
+			mark_as_not_yet_used(buffp->lru_p, page_ent);
+		(*no_free_frames) = 1;
+		return 0;
+	}
+
+	// the complete slot of the page was read, so a compressed page can be decompressed right here
+	if(buffp->extent_map != NULL && decompress_page_in_place(page_memory, page_size, page_id))
+		increment_stat(buffp->stats, pages_read_compressed);
+
+	// just like a page read on a page miss, the page is installed even if its checksum fails
+	if(buffp->page_checksums && !verify_page_checksum(page_memory, page_size))
+	{
+		increment_stat(buffp->stats, checksum_failures);
+		printf("checksum verification failed for page %u\n", page_id);
+	}
+
+	pthread_mutex_lock(&(page_ent->page_entry_lock));
+
+		acquire_write_lock(page_ent);
+			reset_page_to(page_ent, page_id, page_id * buffp->number_of_blocks_per_page, buffp->number_of_blocks_per_page);
+			memcpy(page_ent->page_memory, page_memory, page_size);
+		release_write_lock(page_ent);
+
+		reset_page_entry_dirty(buffp->dirty_throttle, page_ent);
+		set(page_ent, IS_VALID);
+
+		page_ent->usage_count = usage_count;
+		setToCurrentUnixTimestamp(page_ent->unix_timestamp_since_last_disk_io_in_ms);
+
+		insert_page_entry(buffp->pg_tbl, page_ent);
+
+	pthread_mutex_unlock(&(page_ent->page_entry_lock));
+
+	return 1;
+}
+
+PAGE_COUNT load_resident_pages_dump(bufferpool* buffp, char* dump_file_name)
+{
+	FILE* dump_file = fopen(dump_file_name, "rb");
+	if(dump_file == NULL)
+		return 0;
+
+	SIZE_IN_BYTES page_size = buffp->number_of_blocks_per_page * get_block_size(buffp->db_file);
+
+	resident_pages_dump_header header;
+	if(fread(&header, sizeof(header), 1, dump_file) != 1 || header.magic != RESIDENT_PAGES_DUMP_MAGIC
+		|| header.version != RESIDENT_PAGES_DUMP_VERSION || header.page_size != page_size)
+	{
+		fclose(dump_file);
+		return 0;
+	}
+
+	resident_page_entry* entries = malloc(sizeof(resident_page_entry) * header.entries_count);
+	uint32_t entries_count = fread(entries, sizeof(resident_page_entry), header.entries_count, dump_file);
+	fclose(dump_file);
+
+	// if the bufferpool is now smaller, only the most recently used pages of the dump are loaded
+	resident_page_entry* recent_entries = entries;
+	if(entries_count > buffp->pages_in_bufferpool)
+	{
+		recent_entries += (entries_count - buffp->pages_in_bufferpool);
+		entries_count = buffp->pages_in_bufferpool;
+	}
+
+	// the pages are read in the order of their page_ids, so that consecutive pages are read with a single read
+	resident_page_entry* sorted_entries = malloc(sizeof(resident_page_entry) * entries_count);
+	memcpy(sorted_entries, recent_entries, sizeof(resident_page_entry) * entries_count);
+	qsort(sorted_entries, entries_count, sizeof(resident_page_entry), compare_resident_page_entries_by_page_id);
+
+	// the staging memory must be aligned, as the disk io is direct
+	void* staging_memory = mmap(NULL, MAX_PAGES_PER_WARM_UP_READ * page_size, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE, -1, 0);
+
+	PAGE_COUNT pages_loaded = 0;
+	int no_free_frames = 0;
+
+	uint32_t i = 0;
+	while(i < entries_count && !no_free_frames)
+	{
+		// find the run of consecutive page_ids starting at i, skipping the duplicates
+		uint32_t run_end = i + 1;
+		PAGE_COUNT run_pages = 1;
+		while(run_end < entries_count && run_pages < MAX_PAGES_PER_WARM_UP_READ
+			&& sorted_entries[run_end].page_id <= sorted_entries[i].page_id + run_pages)
+		{
+			if(sorted_entries[run_end].page_id == sorted_entries[i].page_id + run_pages)
+				run_pages++;
+			run_end++;
+		}
+
+		int bytes_read = read_blocks_from_disk(buffp->db_file, staging_memory, sorted_entries[i].page_id * buffp->number_of_blocks_per_page, run_pages * buffp->number_of_blocks_per_page);
+
+		// the part of the run beyond the end of the file, is read as zeros
+		if(bytes_read < ((int64_t)run_pages) * page_size)
+			memset(staging_memory + ((bytes_read > 0) ? bytes_read : 0), 0, (run_pages * page_size) - ((bytes_read > 0) ? bytes_read : 0));
+
+		for(uint32_t j = i; j < run_end && !no_free_frames; j++)
+		{
+			if(j > i && sorted_entries[j].page_id == sorted_entries[j - 1].page_id)
+				continue;
+			void* page_memory = staging_memory + (sorted_entries[j].page_id - sorted_entries[i].page_id) * page_size;
+			pages_loaded += install_warm_page(buffp, sorted_entries[j].page_id, sorted_entries[j].usage_count, page_memory, page_size, &no_free_frames);
+		}
+
+		i = run_end;
+	}
+
+	add_to_stat(buffp->stats, pages_read, pages_loaded);
+
+	// put the loaded pages in the lru, from the least to the most recently used
+	for(uint32_t j = 0; j < entries_count; j++)
+	{
+		page_entry* page_ent = find_page_entry_by_page_id(buffp->pg_tbl, recent_entries[j].page_id);
+		if(page_ent == NULL)
+			continue;
+
+		pthread_mutex_lock(&(page_ent->page_entry_lock));
+			if(page_ent->page_id == recent_entries[j].page_id && page_ent->pinned_by_count == 0)
+				mark_as_recently_used(buffp->lru_p, page_ent);
+		pthread_mutex_unlock(&(page_ent->page_entry_lock));
+	}
+
+	munmap(staging_memory, MAX_PAGES_PER_WARM_UP_READ * page_size);
+	free(sorted_entries);
+	free(entries);
+
+	return pages_loaded;
+}
\ No newline at end of file
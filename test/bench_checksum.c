@@ -0,0 +1,146 @@
+#include<stdio.h>
+#include<stdlib.h>
+#include<stdint.h>
+#include<string.h>
+
+#include<dbfile.h>
+#include<page_checksum.h>
+
+/*
+	measures the overhead of the page checksums (see set_page_checksums), relative to the disk io of the pages they are computed for
+
+	for each page size (4 KB, 8 KB and 16 KB), it measures
+		the mean time of a random direct read and of a random direct write of a page, over the first page_count pages of the file (single threaded)
+		the mean time to compute the CRC32C of a page (this is the cost of stamping a page before its write, or of verifying it after its read),
+		with get_crc32c (hardware accelerated, if the cpu supports SSE4.2) and with get_crc32c_portable
+	the results are printed as a tab separated table, one row for each page size, the overheads are the checksum times as a percentage of the io times
+
+	usage :
+		./bench_checksum.out <db_file> [page_count] [seconds_per_run]
+*/
+
+SIZE_IN_BYTES page_sizes[] = {4096, 8192, 16384};
+#define PAGE_SIZES_COUNT (sizeof(page_sizes) / sizeof(page_sizes[0]))
+
+// the checksums are computed over these many distinct pages (round robin), so that they are not all in the L1 cache
+#define CHECKSUMMED_PAGES 256
+
+static uint64_t next_random(uint64_t* state)
+{
+	// xorshift64
+	uint64_t x = *state;
+	x ^= x << 13;
+	x ^= x >> 7;
+	x ^= x << 17;
+	return (*state = x);
+}
+
+// returns the mean time (in nanoseconds) of a random read (or write) of a page, measured for seconds_per_run seconds
+static double measure_page_io(dbfile* dbfilep, void* page, uint32_t blocks_per_page, uint32_t page_count, int is_read, int seconds_per_run)
+{
+	uint64_t random_state = 0x9e3779b97f4a7c15ULL;
+
+	TIMESTAMP_ns start, now;
+	setToCurrentMonotonicTimestamp_ns(start);
+	TIMESTAMP_ns end = start + ((TIME_ns)seconds_per_run) * 1000000000ULL;
+
+	uint64_t ios = 0;
+	do
+	{
+		BLOCK_ID start_block = (next_random(&random_state) % page_count) * blocks_per_page;
+		if(is_read)
+			read_blocks_from_disk(dbfilep, page, start_block, blocks_per_page);
+		else
+			write_blocks_to_disk(dbfilep, page, start_block, blocks_per_page);
+		ios++;
+		setToCurrentMonotonicTimestamp_ns(now);
+	}
+	while(now < end);
+
+	return ((double)(now - start)) / ios;
+}
+
+// returns the mean time (in nanoseconds) to compute the checksum of a page, measured for seconds_per_run seconds
+static double measure_page_checksum(uint32_t (*crc32c)(uint32_t, const void*, size_t), void* pages, SIZE_IN_BYTES page_size, int seconds_per_run)
+{
+	TIMESTAMP_ns start, now;
+	setToCurrentMonotonicTimestamp_ns(start);
+	TIMESTAMP_ns end = start + ((TIME_ns)seconds_per_run) * 1000000000ULL;
+
+	// the checksums are accumulated, so that they are not optimized away
+	volatile uint32_t checksums = 0;
+
+	uint64_t checksums_count = 0;
+	do
+	{
+		for(int i = 0; i < CHECKSUMMED_PAGES; i++)
+			checksums ^= crc32c(0, pages + i * page_size, page_size - sizeof(uint32_t));
+		checksums_count += CHECKSUMMED_PAGES;
+		setToCurrentMonotonicTimestamp_ns(now);
+	}
+	while(now < end);
+
+	return ((double)(now - start)) / checksums_count;
+}
+
+int main(int argc, char** argv)
+{
+	if(argc < 2)
+	{
+		printf("usage : %s <db_file> [page_count] [seconds_per_run]\n", argv[0]);
+		return -1;
+	}
+
+	uint32_t page_count = (argc >= 3) ? atoi(argv[2]) : 1024;
+	int seconds_per_run = (argc >= 4) ? atoi(argv[3]) : 1;
+
+	dbfile* dbfilep = open_dbfile(argv[1]);
+	if(dbfilep == NULL)
+	{
+		dbfilep = create_dbfile(argv[1]);
+		if(dbfilep == NULL)
+		{
+			printf("could not open/create database file at the given path\n");
+			return -1;
+		}
+	}
+
+	SIZE_IN_BYTES block_size = get_block_size(dbfilep);
+
+	printf("crc32c hardware accelerated : %d\n", is_crc32c_hardware_accelerated());
+	printf("page_size\tread_ns\twrite_ns\tcrc32c_ns\tcrc32c_portable_ns\tread_overhead_pct\twrite_overhead_pct\tportable_read_overhead_pct\n");
+
+	for(uint32_t s = 0; s < PAGE_SIZES_COUNT; s++)
+	{
+		SIZE_IN_BYTES page_size = page_sizes[s];
+		if(page_size % block_size != 0)
+			continue;
+		uint32_t blocks_per_page = page_size / block_size;
+
+		// the pages must be aligned to the block size, for the direct io
+		void* alloc_memory = malloc(((size_t)page_size) * CHECKSUMMED_PAGES + block_size);
+		void* pages = (void*)(((((uintptr_t)alloc_memory) / block_size) + 1) * block_size);
+		uint64_t random_state = page_size;
+		for(size_t i = 0; i < ((size_t)page_size) * CHECKSUMMED_PAGES / sizeof(uint64_t); i++)
+			((uint64_t*)pages)[i] = next_random(&random_state);
+
+		// write all the pages once, so that the reads are not of the holes of the file
+		for(uint32_t page_id = 0; page_id < page_count; page_id++)
+			write_blocks_to_disk(dbfilep, pages, page_id * blocks_per_page, blocks_per_page);
+
+		double write_ns = measure_page_io(dbfilep, pages, blocks_per_page, page_count, 0, seconds_per_run);
+		double read_ns = measure_page_io(dbfilep, pages, blocks_per_page, page_count, 1, seconds_per_run);
+		double crc32c_ns = measure_page_checksum(get_crc32c, pages, page_size, seconds_per_run);
+		double crc32c_portable_ns = measure_page_checksum(get_crc32c_portable, pages, page_size, seconds_per_run);
+
+		printf("%u\t%.0lf\t%.0lf\t%.0lf\t%.0lf\t%.2lf\t%.2lf\t%.2lf\n", page_size, read_ns, write_ns, crc32c_ns, crc32c_portable_ns,
+			crc32c_ns * 100.0 / read_ns, crc32c_ns * 100.0 / write_ns, crc32c_portable_ns * 100.0 / read_ns);
+		fflush(stdout);
+
+		free(alloc_memory);
+	}
+
+	close_dbfile(dbfilep);
+
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,217 @@
+#include<stdio.h>
+#include<stdlib.h>
+#include<stdint.h>
+#include<string.h>
+
+#include<pthread.h>
+
+#include<bufferpool.h>
+
+/*
+	measures the throughput and the latency of acquire + release of pages, that are always in the bufferpool (the page hit path)
+	this is where the locking of page_table, lru and page_entry shows up, disk io is never done while measuring
+
+	scenarios :
+		uniform_hits     : readers acquire uniformly random pages of a working set that fits in the bufferpool
+		single_hot_page  : readers acquire the same page, every time
+		mixed_latching   : like uniform_hits, but MIXED_WRITERS_PERCENTAGE % of the accesses acquire writer locks
+		adjacent_frames  : every reader acquires only its own page, the pages of the threads were brought in one after the other, so they are in adjacent frames (page_entries)
+		                   every thread also holds a reader lock on its page for the whole run, so the page stays pinned, and its hits never take the lru_lock
+		                   the threads share no page, so a slowdown with more threads (beyond the page_table lock) comes from the false sharing of the page_entries
+
+	each scenario is run with 1, 2, 4, ... upto max_threads threads, for seconds_per_run seconds each
+	the results are printed as a JSON array, one object for each run
+
+	usage :
+		./bench_hit_path.out <db_file> [max_threads] [seconds_per_run]
+*/
+
+#define PAGE_SIZE_IN_BYTES 4096
+
+#define PAGES_IN_BUFFER_POOL 1024
+#define WORKING_SET_PAGES 512
+#define READ_IO_THREADS_IN_BUFFER_POOL 2
+#define WRITE_IO_THREADS_IN_BUFFER_POOL 1
+
+// the cleanup scheduler sleeps for these many milliseconds between its rounds (and before it notices the shutdown),
+// so they are kept long enough to seldom write the dirty pages while we are measuring, but short enough to not delay delete_bufferpool
+#define DIRTY_PAGES_CLEANUP_EVERY_X_ms 3000
+#define UNUSED_PREFETCHED_PAGES_RETURN_X_ms 3000
+
+#define MIXED_WRITERS_PERCENTAGE 20
+
+typedef enum scenario scenario;
+enum scenario
+{
+	UNIFORM_HITS,
+	SINGLE_HOT_PAGE,
+	MIXED_LATCHING,
+	ADJACENT_FRAMES,
+	SCENARIOS_COUNT
+};
+
+char* scenario_names[SCENARIOS_COUNT] = {"uniform_hits", "single_hot_page", "mixed_latching", "adjacent_frames"};
+
+typedef struct bench_thread bench_thread;
+struct bench_thread
+{
+	pthread_t thread;
+
+	scenario scn;
+
+	// the only page accessed by this thread, in the adjacent_frames scenario
+	PAGE_ID own_page_id;
+
+	uint64_t random_state;
+
+	uint64_t ops;
+
+	latency_histogram latencies;
+};
+
+bufferpool* bpm = NULL;
+
+volatile int start_measuring = 0;
+volatile int stop_measuring = 0;
+
+static uint64_t next_random(uint64_t* state)
+{
+	// xorshift64
+	uint64_t x = *state;
+	x ^= x << 13;
+	x ^= x >> 7;
+	x ^= x << 17;
+	return (*state = x);
+}
+
+static void* bench_thread_function(void* param)
+{
+	bench_thread* bt = param;
+
+	// the extra pin keeps the page out of the lru, so the measured hits do not contend on the lru_lock
+	page_handle pin_handle;
+	if(bt->scn == ADJACENT_FRAMES)
+		pin_handle = acquire_page_with_reader_lock(bpm, bt->own_page_id);
+
+	while(!start_measuring);
+
+	while(!stop_measuring)
+	{
+		uint64_t r = next_random(&(bt->random_state));
+
+		PAGE_ID page_id = (bt->scn == SINGLE_HOT_PAGE) ? 0 : ((bt->scn == ADJACENT_FRAMES) ? bt->own_page_id : (r % WORKING_SET_PAGES));
+		int is_writer = (bt->scn == MIXED_LATCHING) && (((r >> 32) % 100) < MIXED_WRITERS_PERCENTAGE);
+
+		TIMESTAMP_ns start;
+		setToCurrentMonotonicTimestamp_ns(start);
+
+		page_handle pg_handle = is_writer ? acquire_page_with_writer_lock(bpm, page_id) : acquire_page_with_reader_lock(bpm, page_id);
+		if(is_writer)
+			((uint64_t*)(pg_handle.page_memory))[0]++;
+		release_page_lock(bpm, &pg_handle, 0);
+
+		TIMESTAMP_ns end;
+		setToCurrentMonotonicTimestamp_ns(end);
+
+		record_in_latency_histogram(&(bt->latencies), end - start);
+		bt->ops++;
+	}
+
+	if(bt->scn == ADJACENT_FRAMES)
+		release_page_lock(bpm, &pin_handle, 0);
+
+	return NULL;
+}
+
+static void run(scenario scn, int threads_count, int seconds_per_run, int is_first_run)
+{
+	bench_thread* bts = malloc(sizeof(bench_thread) * threads_count);
+
+	start_measuring = 0;
+	stop_measuring = 0;
+
+	for(int i = 0; i < threads_count; i++)
+	{
+		bts[i].scn = scn;
+		bts[i].own_page_id = i % WORKING_SET_PAGES;
+		bts[i].random_state = 0x9e3779b97f4a7c15ULL * (i + 1);
+		bts[i].ops = 0;
+		initialize_latency_histogram(&(bts[i].latencies));
+		pthread_create(&(bts[i].thread), NULL, bench_thread_function, bts + i);
+	}
+
+	TIMESTAMP_ns start;
+	setToCurrentMonotonicTimestamp_ns(start);
+	start_measuring = 1;
+
+	sleepForMilliseconds(((TIME_ms)seconds_per_run) * 1000);
+
+	stop_measuring = 1;
+	TIMESTAMP_ns end;
+	setToCurrentMonotonicTimestamp_ns(end);
+
+	uint64_t ops = 0;
+	latency_histogram latencies;
+	initialize_latency_histogram(&latencies);
+	for(int i = 0; i < threads_count; i++)
+	{
+		pthread_join(bts[i].thread, NULL);
+		ops += bts[i].ops;
+		merge_latency_histogram(&latencies, &(bts[i].latencies));
+	}
+
+	double seconds = ((double)(end - start)) / 1000000000.0;
+
+	printf("%s\t{\"scenario\" : \"%s\", \"threads\" : %d, \"ops\" : %lu, \"ops_per_second\" : %.0f, \"p50_ns\" : %lu, \"p99_ns\" : %lu, \"p999_ns\" : %lu, \"max_ns\" : %lu}",
+		is_first_run ? "" : ",\n", scenario_names[scn], threads_count, ops, ops / seconds,
+		get_percentile_of_latency_histogram(&latencies, 50.0), get_percentile_of_latency_histogram(&latencies, 99.0),
+		get_percentile_of_latency_histogram(&latencies, 99.9), get_percentile_of_latency_histogram(&latencies, 100.0));
+	fflush(stdout);
+
+	free(bts);
+}
+
+int main(int argc, char** argv)
+{
+	if(argc < 2)
+	{
+		printf("usage : %s <db_file> [max_threads] [seconds_per_run]\n", argv[0]);
+		return -1;
+	}
+
+	int max_threads = (argc >= 3) ? atoi(argv[2]) : 8;
+	int seconds_per_run = (argc >= 4) ? atoi(argv[3]) : 1;
+
+	bpm = get_bufferpool(argv[1], PAGES_IN_BUFFER_POOL, PAGE_SIZE_IN_BYTES, READ_IO_THREADS_IN_BUFFER_POOL, WRITE_IO_THREADS_IN_BUFFER_POOL, DIRTY_PAGES_CLEANUP_EVERY_X_ms, UNUSED_PREFETCHED_PAGES_RETURN_X_ms);
+	if(bpm == NULL)
+		return -1;
+
+	// bring the working set to memory, before measuring
+	for(PAGE_ID page_id = 0; page_id < WORKING_SET_PAGES; page_id++)
+	{
+		page_handle pg_handle = acquire_page_with_reader_lock(bpm, page_id);
+		release_page_lock(bpm, &pg_handle, 0);
+	}
+
+	printf("[\n");
+	int is_first_run = 1;
+	for(scenario scn = 0; scn < SCENARIOS_COUNT; scn++)
+	{
+		for(int threads_count = 1; threads_count <= max_threads; threads_count *= 2)
+		{
+			run(scn, threads_count, seconds_per_run, is_first_run);
+			is_first_run = 0;
+		}
+	}
+	printf("\n]\n");
+
+	// the working set must not have been evicted while measuring, else we did not measure the hit path
+	bufferpool_stats stats;
+	get_bufferpool_stats(bpm, &stats);
+	if(stats.page_misses > WORKING_SET_PAGES)
+		fprintf(stderr, "%lu page misses while measuring, the results include disk io\n", stats.page_misses - WORKING_SET_PAGES);
+
+	delete_bufferpool(bpm);
+
+	return 0;
+}
\ No newline at end of file
@@ -1,5 +1,9 @@
 #include<bounded_blocking_queue.h>
 #include<job.h>
+#include<promise.h>
+
+#include<stdio.h>
+#include<stdlib.h>
 
 void* producer_function(void* q)
 {
@@ -30,24 +34,93 @@ void* consumer_function(void* q)
 	return NULL;
 }
 
+#define BATCH_PRODUCERS 4
+#define PAGES_PER_BATCH_PRODUCER 100000
+#define BATCH_SIZE 7
+
+// each batch producer pushes the page ids 1 to PAGES_PER_BATCH_PRODUCER, in batches of BATCH_SIZE
+void* batch_producer_function(void* q)
+{
+	bbqueue* bbq = (bbqueue*)q;
+	PAGE_ID batch[BATCH_SIZE];
+	uint32_t batch_count = 0;
+	for(PAGE_ID page_id = 1; page_id <= PAGES_PER_BATCH_PRODUCER; page_id++)
+	{
+		batch[batch_count++] = page_id;
+		if(batch_count == BATCH_SIZE || page_id == PAGES_PER_BATCH_PRODUCER)
+		{
+			push_bbqueue_batch(bbq, batch, batch_count);
+			batch_count = 0;
+		}
+	}
+	return NULL;
+}
+
 int main()
 {
 	uint32_t element_count = 10;
-	bbqueue* bbq = get_bbqueue(10);
+	bbqueue* bbq = get_bbqueue(element_count);
 
-	job* producer_job = get_job(producer_function, bbq);
-	job* consumer_job = get_job(consumer_function, bbq);
+	promise* producer_completion_promise = get_promise();
+	promise* consumer_completion_promise = get_promise();
+
+	job* producer_job = get_job(producer_function, bbq, producer_completion_promise);
+	job* consumer_job = get_job(consumer_function, bbq, consumer_completion_promise);
 
 	execute_async(producer_job);
 	execute_async(consumer_job);
 
-	get_result(producer_job);
-	get_result(consumer_job);
+	get_promised_result(producer_completion_promise);
+	get_promised_result(consumer_completion_promise);
+
+	delete_promise(producer_completion_promise);
+	delete_promise(consumer_completion_promise);
 
 	delete_job(producer_job);
 	delete_job(consumer_job);
 
-	free(bbq);
+	delete_bbqueue(bbq);
+
+	// many batch producers and a single batch consumer, through a queue smaller than a batch of the consumer
+	bbq = get_bbqueue(5);
+
+	promise* batch_producer_completion_promises[BATCH_PRODUCERS];
+	job* batch_producer_jobs[BATCH_PRODUCERS];
+	for(int i = 0; i < BATCH_PRODUCERS; i++)
+	{
+		batch_producer_completion_promises[i] = get_promise();
+		batch_producer_jobs[i] = get_job(batch_producer_function, bbq, batch_producer_completion_promises[i]);
+		execute_async(batch_producer_jobs[i]);
+	}
+
+	uint64_t expected_sum = ((uint64_t)BATCH_PRODUCERS) * PAGES_PER_BATCH_PRODUCER * (PAGES_PER_BATCH_PRODUCER + 1) / 2;
+	uint64_t sum = 0;
+	uint64_t popped_count = 0;
+	uint64_t pop_calls = 0;
+	while(popped_count < ((uint64_t)BATCH_PRODUCERS) * PAGES_PER_BATCH_PRODUCER)
+	{
+		PAGE_ID page_ids[16];
+		uint32_t count = pop_bbqueue_batch(bbq, page_ids, 16);
+		for(uint32_t i = 0; i < count; i++)
+			sum += page_ids[i];
+		popped_count += count;
+		pop_calls++;
+	}
+
+	for(int i = 0; i < BATCH_PRODUCERS; i++)
+	{
+		get_promised_result(batch_producer_completion_promises[i]);
+		delete_promise(batch_producer_completion_promises[i]);
+		delete_job(batch_producer_jobs[i]);
+	}
+
+	int is_passed = (sum == expected_sum && is_bbqueue_empty(bbq));
+
+	printf("\nbatch test : popped %lu page ids in %lu calls, sum %lu, expected sum %lu, queue is %s, test %s\n",
+		popped_count, pop_calls, sum, expected_sum, is_bbqueue_empty(bbq) ? "empty" : "not empty",
+		is_passed ? "PASSED" : "FAILED");
+
+	delete_bbqueue(bbq);
 
-	return 0;
+	return is_passed ? 0 : 1;
 }
\ No newline at end of file
@@ -13,7 +13,8 @@
 
 #define PAGES_IN_HEAP_FILE 20
 #define MAX_PAGES_IN_BUFFER_POOL 6
-#define MAX_IO_THREADS_IN_BUFFER_POOL 4
+#define READ_IO_THREADS_IN_BUFFER_POOL 4
+#define WRITE_IO_THREADS_IN_BUFFER_POOL 2
 #define DIRTY_PAGES_CLEANUP_EVERY_X_ms 1000
 #define UNUSED_PREFETCHED_PAGES_RETURN_X_ms 20
 
@@ -65,10 +66,14 @@ int main(int argc, char **argv)
 		strcpy(file_name, argv[1]);
 	}
 
-	bpm = get_bufferpool(file_name, MAX_PAGES_IN_BUFFER_POOL, PAGE_SIZE_IN_BYTES, MAX_IO_THREADS_IN_BUFFER_POOL, DIRTY_PAGES_CLEANUP_EVERY_X_ms, UNUSED_PREFETCHED_PAGES_RETURN_X_ms);
+	bpm = get_bufferpool(file_name, MAX_PAGES_IN_BUFFER_POOL, PAGE_SIZE_IN_BYTES, READ_IO_THREADS_IN_BUFFER_POOL, WRITE_IO_THREADS_IN_BUFFER_POOL, DIRTY_PAGES_CLEANUP_EVERY_X_ms, UNUSED_PREFETCHED_PAGES_RETURN_X_ms);
 	if(bpm != NULL)
 	{
 		printf("Bufferpool built for file %s\n\n", file_name);
+
+		// if a trace file name is given, trace all the page accesses of the test, the trace can be replayed using trace_replay.out
+		if(argc >= 3 && start_page_access_trace(bpm, argv[2], 4096))
+			printf("Tracing page accesses to file %s\n\n", argv[2]);
 	}
 	else
 	{
@@ -145,6 +150,22 @@ int main(int argc, char **argv)
 		usleep(DELAY_AFTER_IO_TASKS_ARE_COMPLETED * 1000);
 	#endif
 
+	bufferpool_stats stats;
+	get_bufferpool_stats(bpm, &stats);
+	printf("\nhits = %lu, misses = %lu, evictions = %lu\n", stats.page_hits, stats.page_misses, stats.evictions);
+	printf("writebacks on miss path = %lu, writebacks by cleanup = %lu\n", stats.writebacks_on_miss_path, stats.writebacks_by_cleanup);
+	printf("page requests created = %lu, piggybacked = %lu, pages prefetched = %lu, unused prefetched pages = %lu\n\n", stats.page_requests_created, stats.page_requests_piggybacked, stats.pages_prefetched, stats.unused_prefetched_pages);
+
+	char* latency_names[BUFFERPOOL_LATENCIES_COUNT] = {"acquire page", "page request queue", "disk read", "disk write", "force write wait"};
+	for(int l = 0; l < BUFFERPOOL_LATENCIES_COUNT; l++)
+	{
+		latency_histogram hist;
+		get_bufferpool_latency_histogram(bpm, l, &hist);
+		printf("%s latency (ns) : count = %lu, p50 = %lu, p99 = %lu, p99.9 = %lu\n", latency_names[l], get_count_of_latency_histogram(&hist),
+			get_percentile_of_latency_histogram(&hist, 50.0), get_percentile_of_latency_histogram(&hist, 99.0), get_percentile_of_latency_histogram(&hist, 99.9));
+	}
+	printf("\n");
+
 	delete_bufferpool(bpm);
 
 	delete_bbqueue(bbq);
@@ -199,7 +220,8 @@ void* io_task_execute(io_task* io_t_p)
 
 void page_read_and_print(uint32_t page_id)
 {
-	void* page_mem = acquire_page_with_reader_lock(bpm, page_id);
+	page_handle pg_handle = acquire_page_with_reader_lock(bpm, page_id);
+	void* page_mem = pg_handle.page_memory;
 
 	if(page_mem)
 	{
@@ -221,7 +243,7 @@ void page_read_and_print(uint32_t page_id)
 			usleep(IO_TASK_LATENCY_IN_MS * 1000);
 		#endif
 
-		if(release_page_lock(bpm, page_mem, 0))
+		if(release_page_lock(bpm, &pg_handle, 0))
 		{
 			printf("page %u released from read lock\n\n", page_id);
 		}
@@ -238,7 +260,8 @@ void page_read_and_print(uint32_t page_id)
 
 void page_write_and_print(uint32_t page_id)
 {
-	void* page_mem = acquire_page_with_writer_lock(bpm, page_id);
+	page_handle pg_handle = acquire_page_with_writer_lock(bpm, page_id);
+	void* page_mem = pg_handle.page_memory;
 	if(page_mem)
 	{
 		printf("page %u locked for write\n", page_id);
@@ -274,7 +297,7 @@ void page_write_and_print(uint32_t page_id)
 			usleep(IO_TASK_LATENCY_IN_MS * 1000);
 		#endif
 
-		if(release_page_lock(bpm, page_mem, 0))
+		if(release_page_lock(bpm, &pg_handle, 0))
 		{
 			printf("page %u released from write lock\n\n", page_id);
 		}
@@ -291,7 +314,8 @@ void page_write_and_print(uint32_t page_id)
 
 void blankify_new_page(uint32_t page_id)
 {
-	void* page_mem = acquire_page_with_writer_lock(bpm, page_id);
+	page_handle pg_handle = acquire_page_with_writer_lock(bpm, page_id);
+	void* page_mem = pg_handle.page_memory;
 	if(page_mem)
 	{
 		printf("page %u locked for write\n", page_id);
@@ -299,7 +323,7 @@ void blankify_new_page(uint32_t page_id)
 		memset(page_mem, ' ', PAGE_SIZE_IN_BYTES);
 		sprintf(page_mem, PAGE_DATA_FORMAT, page_id, 0);
 		printf("new Data written on page %u : \t <%s>\n", page_id, (char*)page_mem);
-		if(release_page_lock(bpm, page_mem, 1))
+		if(release_page_lock(bpm, &pg_handle, 1))
 		{
 			printf("page %u released from write lock\n\n", page_id);
 		}
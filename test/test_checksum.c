@@ -0,0 +1,139 @@
+#include<stdio.h>
+#include<stdlib.h>
+#include<stdint.h>
+#include<string.h>
+
+#include<fcntl.h>
+#include<unistd.h>
+
+#include<bufferpool.h>
+#include<page_checksum.h>
+
+/*
+	tests the page checksums (see set_page_checksums)
+
+	it writes TEST_PAGES pages with checksums enabled, and closes the bufferpool (writing them to disk)
+	then it flips one byte of the page CORRUPTED_PAGE_ID directly in the heap file (using pwrite), and reopens the bufferpool with checksums enabled
+	reading back all the pages, must report exactly 1 checksum failure, and the rest of the pages must read back intact
+
+	the db_file is deleted first, since the checksums must be enabled since the file was created
+
+	usage :
+		./test_checksum.out <db_file>
+*/
+
+#define PAGE_SIZE_IN_BYTES 4096
+
+#define TEST_PAGES 8
+#define PAGES_IN_BUFFER_POOL 16
+#define READ_IO_THREADS_IN_BUFFER_POOL 2
+#define WRITE_IO_THREADS_IN_BUFFER_POOL 1
+#define DIRTY_PAGES_CLEANUP_EVERY_X_ms 100
+#define UNUSED_PREFETCHED_PAGES_RETURN_X_ms 1000
+
+#define CORRUPTED_PAGE_ID 3
+#define CORRUPTED_BYTE_OFFSET_IN_PAGE 100
+
+// the contents of a page, its last PAGE_CHECKSUM_FOOTER_SIZE bytes belong to the checksum footer and are never written by us
+static void fill_page(void* page_memory, PAGE_ID page_id)
+{
+	for(uint32_t i = 0; i < PAGE_SIZE_IN_BYTES - PAGE_CHECKSUM_FOOTER_SIZE; i++)
+		((uint8_t*)page_memory)[i] = (uint8_t)(page_id * 31 + i);
+}
+
+static int is_page_intact(const void* page_memory, PAGE_ID page_id)
+{
+	for(uint32_t i = 0; i < PAGE_SIZE_IN_BYTES - PAGE_CHECKSUM_FOOTER_SIZE; i++)
+	{
+		if(((const uint8_t*)page_memory)[i] != (uint8_t)(page_id * 31 + i))
+			return 0;
+	}
+	return 1;
+}
+
+static bufferpool* get_test_bufferpool(char* file_name)
+{
+	bufferpool* bpm = get_bufferpool(file_name, PAGES_IN_BUFFER_POOL, PAGE_SIZE_IN_BYTES, READ_IO_THREADS_IN_BUFFER_POOL, WRITE_IO_THREADS_IN_BUFFER_POOL, DIRTY_PAGES_CLEANUP_EVERY_X_ms, UNUSED_PREFETCHED_PAGES_RETURN_X_ms);
+	if(bpm != NULL)
+		set_page_checksums(bpm, 1);
+	return bpm;
+}
+
+// flips a byte of the page in the heap file, behind the back of the bufferpool
+static int corrupt_page_on_disk(char* file_name, PAGE_ID page_id)
+{
+	int fd = open(file_name, O_RDWR);
+	if(fd == -1)
+		return 0;
+
+	off_t offset = ((off_t)page_id) * PAGE_SIZE_IN_BYTES + CORRUPTED_BYTE_OFFSET_IN_PAGE;
+	uint8_t byte;
+	int result = (pread(fd, &byte, 1, offset) == 1);
+	byte ^= 0xff;
+	result = result && (pwrite(fd, &byte, 1, offset) == 1) && (fsync(fd) == 0);
+
+	close(fd);
+	return result;
+}
+
+int main(int argc, char** argv)
+{
+	char* file_name = (argc >= 2) ? argv[1] : "./test.db";
+	unlink(file_name);
+
+	bufferpool* bpm = get_test_bufferpool(file_name);
+	if(bpm == NULL)
+	{
+		printf("Bufferpool can not be built for file %s, please check errors\n", file_name);
+		return 1;
+	}
+
+	for(PAGE_ID page_id = 0; page_id < TEST_PAGES; page_id++)
+	{
+		page_handle pg_handle = acquire_page_with_writer_lock(bpm, page_id);
+		fill_page(pg_handle.page_memory, page_id);
+		release_page_lock(bpm, &pg_handle, 1);
+	}
+
+	// all the dirty pages are written (and stamped) before the bufferpool is deleted
+	delete_bufferpool(bpm);
+
+	if(!corrupt_page_on_disk(file_name, CORRUPTED_PAGE_ID))
+	{
+		printf("could not corrupt page %u of file %s\n", CORRUPTED_PAGE_ID, file_name);
+		return 1;
+	}
+
+	bpm = get_test_bufferpool(file_name);
+	if(bpm == NULL)
+	{
+		printf("Bufferpool can not be rebuilt for file %s, please check errors\n", file_name);
+		return 1;
+	}
+
+	int intact_pages = 0;
+	int is_corruption_visible = 0;
+	for(PAGE_ID page_id = 0; page_id < TEST_PAGES; page_id++)
+	{
+		page_handle pg_handle = acquire_page_with_reader_lock(bpm, page_id);
+		if(is_page_intact(pg_handle.page_memory, page_id))
+			intact_pages++;
+		else if(page_id == CORRUPTED_PAGE_ID)
+			is_corruption_visible = 1;
+		release_page_lock(bpm, &pg_handle, 1);
+	}
+
+	bufferpool_stats stats;
+	get_bufferpool_stats(bpm, &stats);
+
+	delete_bufferpool(bpm);
+
+	int is_passed = (stats.checksum_failures == 1) && (intact_pages == TEST_PAGES - 1) && is_corruption_visible;
+
+	printf("\nchecksum test : %lu checksum failures (expected 1), %d of %d pages intact, corrupted page %u %s, test %s\n",
+		stats.checksum_failures, intact_pages, TEST_PAGES, CORRUPTED_PAGE_ID,
+		is_corruption_visible ? "read back corrupted" : "not read back corrupted",
+		is_passed ? "PASSED" : "FAILED");
+
+	return is_passed ? 0 : 1;
+}
\ No newline at end of file
@@ -1,2 +1,10 @@
 gcc -o test_bpm.out test_bpm.c -lbufferpool -lboompar -lrwlock -lpthread -lcutlery
-#gcc -o test_io.out test_io.c -lbufferpool -lboompar -lrwlock -lpthread -lcutlery
\ No newline at end of file
+gcc -O2 -o test_bbq.out test_bbq.c -lbufferpool -lboompar -lrwlock -lpthread -lcutlery
+gcc -o trace_replay.out trace_replay.c -lbufferpool -lboompar -lrwlock -lpthread -lcutlery
+gcc -O2 -o bench_hit_path.out bench_hit_path.c -lbufferpool -lboompar -lrwlock -lpthread -lcutlery
+gcc -O2 -o workload_driver.out workload_driver.c -lbufferpool -lboompar -lrwlock -lpthread -lcutlery -lm
+gcc -o test_io.out test_io.c -lbufferpool -lboompar -lrwlock -lpthread -lcutlery
+gcc -O2 -o bench_checksum.out bench_checksum.c -lbufferpool -lboompar -lrwlock -lpthread -lcutlery
+gcc -o test_checksum.out test_checksum.c -lbufferpool -lboompar -lrwlock -lpthread -lcutlery
+gcc -o test_compression.out test_compression.c -lbufferpool -lboompar -lrwlock -lpthread -lcutlery
+gcc -o test_free_pages.out test_free_pages.c -lbufferpool -lboompar -lrwlock -lpthread -lcutlery
\ No newline at end of file
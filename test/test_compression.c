@@ -0,0 +1,145 @@
+#include<stdio.h>
+#include<stdlib.h>
+#include<stdint.h>
+#include<string.h>
+
+#include<unistd.h>
+
+#include<bufferpool.h>
+
+/*
+	tests the round trip of the pages through the on disk compression (see set_page_compression)
+
+	it writes TEST_PAGES pages with page compression enabled, the even pages compress well (repeated text) and the odd pages do not compress at all (random bytes)
+	and it closes the bufferpool (writing them to disk), then the pages are read back twice, each time by a new bufferpool with page compression enabled
+		first with the extent map file, that was written along with the pages
+		then without it (the extent map file is deleted), the pages must still read back correctly (only with larger reads)
+	every page must read back intact, and only the even pages must be written and read compressed
+
+	the db_file and the extent map file are deleted first
+
+	usage :
+		./test_compression.out <db_file> [extent_map_file]
+*/
+
+#define PAGE_SIZE_IN_BYTES 4096
+
+#define TEST_PAGES 16
+#define PAGES_IN_BUFFER_POOL 32
+#define READ_IO_THREADS_IN_BUFFER_POOL 2
+#define WRITE_IO_THREADS_IN_BUFFER_POOL 1
+#define DIRTY_PAGES_CLEANUP_EVERY_X_ms 100
+#define UNUSED_PREFETCHED_PAGES_RETURN_X_ms 1000
+
+#define COMPRESSIBLE_PAGE_FORMAT "page number %u compresses well, since this line repeats till the end of the page\n"
+
+static void fill_page(void* page_memory, PAGE_ID page_id)
+{
+	if(page_id % 2 == 0)
+	{
+		char line[128];
+		int line_length = snprintf(line, sizeof(line), COMPRESSIBLE_PAGE_FORMAT, page_id);
+		for(uint32_t i = 0; i < PAGE_SIZE_IN_BYTES; i++)
+			((char*)page_memory)[i] = line[i % line_length];
+	}
+	else
+	{
+		// xorshift32, seeded by the page_id, so the page can be regenerated for the comparison
+		uint32_t x = 0x9e3779b9 ^ page_id;
+		for(uint32_t i = 0; i < PAGE_SIZE_IN_BYTES; i++)
+		{
+			x ^= x << 13;
+			x ^= x >> 17;
+			x ^= x << 5;
+			((uint8_t*)page_memory)[i] = (uint8_t)x;
+		}
+	}
+}
+
+static bufferpool* get_test_bufferpool(char* file_name, char* extent_map_file_name)
+{
+	bufferpool* bpm = get_bufferpool(file_name, PAGES_IN_BUFFER_POOL, PAGE_SIZE_IN_BYTES, READ_IO_THREADS_IN_BUFFER_POOL, WRITE_IO_THREADS_IN_BUFFER_POOL, DIRTY_PAGES_CLEANUP_EVERY_X_ms, UNUSED_PREFETCHED_PAGES_RETURN_X_ms);
+	if(bpm != NULL && !set_page_compression(bpm, extent_map_file_name))
+	{
+		printf("could not open the extent map file %s\n", extent_map_file_name);
+		delete_bufferpool(bpm);
+		return NULL;
+	}
+	return bpm;
+}
+
+// reads back all the test pages using a new bufferpool, returns the number of pages that read back intact
+static int read_back_pages(char* file_name, char* extent_map_file_name, bufferpool_stats* stats)
+{
+	bufferpool* bpm = get_test_bufferpool(file_name, extent_map_file_name);
+	if(bpm == NULL)
+		return -1;
+
+	char expected_page[PAGE_SIZE_IN_BYTES];
+	int intact_pages = 0;
+	for(PAGE_ID page_id = 0; page_id < TEST_PAGES; page_id++)
+	{
+		fill_page(expected_page, page_id);
+		page_handle pg_handle = acquire_page_with_reader_lock(bpm, page_id);
+		if(memcmp(pg_handle.page_memory, expected_page, PAGE_SIZE_IN_BYTES) == 0)
+			intact_pages++;
+		else
+			printf("page %u did not read back intact\n", page_id);
+		release_page_lock(bpm, &pg_handle, 1);
+	}
+
+	get_bufferpool_stats(bpm, stats);
+
+	delete_bufferpool(bpm);
+
+	return intact_pages;
+}
+
+int main(int argc, char** argv)
+{
+	char* file_name = (argc >= 2) ? argv[1] : "./test.db";
+
+	char extent_map_file_name[512];
+	if(argc >= 3)
+		snprintf(extent_map_file_name, sizeof(extent_map_file_name), "%s", argv[2]);
+	else
+		snprintf(extent_map_file_name, sizeof(extent_map_file_name), "%s.extents", file_name);
+
+	unlink(file_name);
+	unlink(extent_map_file_name);
+
+	bufferpool* bpm = get_test_bufferpool(file_name, extent_map_file_name);
+	if(bpm == NULL)
+	{
+		printf("Bufferpool can not be built for file %s, please check errors\n", file_name);
+		return 1;
+	}
+
+	for(PAGE_ID page_id = 0; page_id < TEST_PAGES; page_id++)
+	{
+		page_handle pg_handle = acquire_page_with_writer_lock(bpm, page_id);
+		fill_page(pg_handle.page_memory, page_id);
+		release_page_lock(bpm, &pg_handle, 1);
+	}
+
+	// all the dirty pages are written (compressed, if they compress by atleast a block) before the bufferpool is deleted
+	delete_bufferpool(bpm);
+
+	bufferpool_stats with_extent_map_stats;
+	int intact_with_extent_map = read_back_pages(file_name, extent_map_file_name, &with_extent_map_stats);
+
+	unlink(extent_map_file_name);
+
+	bufferpool_stats without_extent_map_stats;
+	int intact_without_extent_map = read_back_pages(file_name, extent_map_file_name, &without_extent_map_stats);
+
+	int is_passed = (intact_with_extent_map == TEST_PAGES) && (with_extent_map_stats.pages_read_compressed == TEST_PAGES / 2)
+					&& (intact_without_extent_map == TEST_PAGES) && (without_extent_map_stats.pages_read_compressed == TEST_PAGES / 2);
+
+	printf("\ncompression test : with the extent map %d of %d pages intact, %lu read compressed, without the extent map %d of %d pages intact, %lu read compressed (expected %d), test %s\n",
+		intact_with_extent_map, TEST_PAGES, with_extent_map_stats.pages_read_compressed,
+		intact_without_extent_map, TEST_PAGES, without_extent_map_stats.pages_read_compressed,
+		TEST_PAGES / 2, is_passed ? "PASSED" : "FAILED");
+
+	return is_passed ? 0 : 1;
+}
\ No newline at end of file
@@ -0,0 +1,147 @@
+#include<stdio.h>
+#include<stdlib.h>
+#include<stdint.h>
+#include<string.h>
+
+#include<unistd.h>
+
+#include<bufferpool.h>
+
+/*
+	tests free_pages_on_disk
+
+	it writes TEST_PAGES pages of non zero data, and closes the bufferpool (writing them to disk)
+	then with a new bufferpool, it reads all the pages (so they are resident), dirties one of the pages to be freed, and frees FREED_PAGE_COUNT pages from FREED_START_PAGE_ID
+	freeing a page that is held (pinned) by the test itself, must be refused without freeing it
+	the freed pages must read back as zeros, both from this bufferpool and from a bufferpool opened later over the same file (the dirty page must never be written back)
+	and the rest of the pages (including the refused one) must read back intact
+
+	the db_file is deleted first
+
+	usage :
+		./test_free_pages.out <db_file>
+*/
+
+#define PAGE_SIZE_IN_BYTES 4096
+
+#define TEST_PAGES 8
+#define PAGES_IN_BUFFER_POOL 16
+#define READ_IO_THREADS_IN_BUFFER_POOL 2
+#define WRITE_IO_THREADS_IN_BUFFER_POOL 1
+#define DIRTY_PAGES_CLEANUP_EVERY_X_ms 100
+#define UNUSED_PREFETCHED_PAGES_RETURN_X_ms 1000
+
+#define FREED_START_PAGE_ID 2
+#define FREED_PAGE_COUNT 3
+#define PINNED_PAGE_ID 6
+
+static int is_freed_page(PAGE_ID page_id)
+{
+	return FREED_START_PAGE_ID <= page_id && page_id < FREED_START_PAGE_ID + FREED_PAGE_COUNT;
+}
+
+static void fill_page(void* page_memory, PAGE_ID page_id)
+{
+	for(uint32_t i = 0; i < PAGE_SIZE_IN_BYTES; i++)
+		((uint8_t*)page_memory)[i] = (uint8_t)(page_id * 31 + i) | 1;
+}
+
+static int is_page_all_zeros(const void* page_memory)
+{
+	for(uint32_t i = 0; i < PAGE_SIZE_IN_BYTES; i++)
+	{
+		if(((const uint8_t*)page_memory)[i] != 0)
+			return 0;
+	}
+	return 1;
+}
+
+// returns the number of the test pages, that read back as expected (zeros for the freed pages, and their data for the rest)
+static int check_pages(bufferpool* bpm)
+{
+	char expected_page[PAGE_SIZE_IN_BYTES];
+	int correct_pages = 0;
+	for(PAGE_ID page_id = 0; page_id < TEST_PAGES; page_id++)
+	{
+		fill_page(expected_page, page_id);
+		page_handle pg_handle = acquire_page_with_reader_lock(bpm, page_id);
+		int is_correct = is_freed_page(page_id) ? is_page_all_zeros(pg_handle.page_memory) : (memcmp(pg_handle.page_memory, expected_page, PAGE_SIZE_IN_BYTES) == 0);
+		if(is_correct)
+			correct_pages++;
+		else
+			printf("page %u did not read back as expected\n", page_id);
+		release_page_lock(bpm, &pg_handle, 0);
+	}
+	return correct_pages;
+}
+
+static bufferpool* get_test_bufferpool(char* file_name)
+{
+	return get_bufferpool(file_name, PAGES_IN_BUFFER_POOL, PAGE_SIZE_IN_BYTES, READ_IO_THREADS_IN_BUFFER_POOL, WRITE_IO_THREADS_IN_BUFFER_POOL, DIRTY_PAGES_CLEANUP_EVERY_X_ms, UNUSED_PREFETCHED_PAGES_RETURN_X_ms);
+}
+
+int main(int argc, char** argv)
+{
+	char* file_name = (argc >= 2) ? argv[1] : "./test.db";
+	unlink(file_name);
+
+	bufferpool* bpm = get_test_bufferpool(file_name);
+	if(bpm == NULL)
+	{
+		printf("Bufferpool can not be built for file %s, please check errors\n", file_name);
+		return 1;
+	}
+
+	for(PAGE_ID page_id = 0; page_id < TEST_PAGES; page_id++)
+	{
+		page_handle pg_handle = acquire_page_with_writer_lock(bpm, page_id);
+		fill_page(pg_handle.page_memory, page_id);
+		release_page_lock(bpm, &pg_handle, 1);
+	}
+
+	delete_bufferpool(bpm);
+
+	bpm = get_test_bufferpool(file_name);
+	if(bpm == NULL)
+	{
+		printf("Bufferpool can not be rebuilt for file %s, please check errors\n", file_name);
+		return 1;
+	}
+
+	// make all the pages resident, and dirty one of the pages to be freed (with the same data), it must be dropped without being written
+	for(PAGE_ID page_id = 0; page_id < TEST_PAGES; page_id++)
+	{
+		page_handle pg_handle = (page_id == FREED_START_PAGE_ID) ? acquire_page_with_writer_lock(bpm, page_id) : acquire_page_with_reader_lock(bpm, page_id);
+		release_page_lock(bpm, &pg_handle, 0);
+	}
+
+	page_handle pinned_handle = acquire_page_with_reader_lock(bpm, PINNED_PAGE_ID);
+	int is_pinned_free_refused = !free_pages_on_disk(bpm, PINNED_PAGE_ID, 1);
+	release_page_lock(bpm, &pinned_handle, 0);
+
+	int is_freed = free_pages_on_disk(bpm, FREED_START_PAGE_ID, FREED_PAGE_COUNT);
+
+	int correct_before_reopen = check_pages(bpm);
+
+	delete_bufferpool(bpm);
+
+	bpm = get_test_bufferpool(file_name);
+	if(bpm == NULL)
+	{
+		printf("Bufferpool can not be rebuilt for file %s, please check errors\n", file_name);
+		return 1;
+	}
+
+	int correct_after_reopen = check_pages(bpm);
+
+	delete_bufferpool(bpm);
+
+	int is_passed = is_pinned_free_refused && is_freed && (correct_before_reopen == TEST_PAGES) && (correct_after_reopen == TEST_PAGES);
+
+	printf("\nfree pages test : free of a pinned page %s, free of %d pages %s, %d of %d pages read back as expected, %d of %d after reopening, test %s\n",
+		is_pinned_free_refused ? "refused" : "not refused", FREED_PAGE_COUNT, is_freed ? "succeeded" : "failed (can the file system punch holes ?)",
+		correct_before_reopen, TEST_PAGES, correct_after_reopen, TEST_PAGES,
+		is_passed ? "PASSED" : "FAILED");
+
+	return is_passed ? 0 : 1;
+}
\ No newline at end of file
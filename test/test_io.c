@@ -1,12 +1,155 @@
 #include<dbfile.h>
+#include<latency_histogram.h>
 
 #include<time.h>
+#include<pthread.h>
+
+/*
+	usage :
+		./test_io.out <file> <block_count> <blocks_per_page> [max_queue_depth] [seconds_per_run]
+
+	tests 1 to 4 compare single threaded sequential io against page by page io, over the first block_count blocks of the file
+
+	if max_queue_depth is given, it then characterizes the device with a sweep of random io over the same blocks, for every combination of
+		queue depth   : 1, 2, 4, ... upto max_queue_depth, the number of threads doing synchronous io concurrently (like the read/write io_thread_count-s of get_bufferpool)
+		request size  : 1 block, 1 page, 4 pages and 16 pages (the bigger ones tell you how much coalescing adjacent pages in to a single io would gain)
+		read/write mix: 100 %, 70 % and 0 % reads
+	each run lasts seconds_per_run seconds (default 1), and the results are printed as a tab separated table, one row for each run
+*/
+
+// the percentage of reads, in each of the runs of the sweep
+int read_percentages[] = {100, 70, 0};
+#define READ_PERCENTAGES_COUNT (sizeof(read_percentages) / sizeof(read_percentages[0]))
+
+// the request sizes of the sweep, in pages (a request size of 0 pages means a single block)
+uint32_t request_sizes_in_pages[] = {0, 1, 4, 16};
+#define REQUEST_SIZES_COUNT (sizeof(request_sizes_in_pages) / sizeof(request_sizes_in_pages[0]))
 
 double diff_timespec(struct timespec tstart, struct timespec tend)
 {
 	return ((double)tend.tv_sec + 1.0e-9*tend.tv_nsec) - ((double)tstart.tv_sec + 1.0e-9*tstart.tv_nsec);
 }
 
+typedef struct io_thread io_thread;
+struct io_thread
+{
+	pthread_t thread;
+
+	dbfile* dbfilep;
+
+	// the region of the file this thread does io on, and the number of blocks to read/write with each request
+	uint32_t block_count;
+	uint32_t request_blocks;
+	int read_percentage;
+
+	void* alloc_memory;
+	void* buffer;
+
+	uint64_t random_state;
+
+	uint64_t ios;
+	uint64_t io_errors;
+	latency_histogram latencies;
+};
+
+volatile int stop_io = 0;
+
+static uint64_t next_random(uint64_t* state)
+{
+	// xorshift64
+	uint64_t x = *state;
+	x ^= x << 13;
+	x ^= x >> 7;
+	x ^= x << 17;
+	return (*state = x);
+}
+
+static void* io_thread_function(void* param)
+{
+	io_thread* iot = param;
+
+	// requests are aligned to their own size, as the bufferpool does for the pages
+	uint32_t request_slots = iot->block_count / iot->request_blocks;
+
+	while(!stop_io)
+	{
+		uint64_t r = next_random(&(iot->random_state));
+		uint32_t start_block = (r % request_slots) * iot->request_blocks;
+		int is_read = ((r >> 32) % 100) < iot->read_percentage;
+
+		TIMESTAMP_ns start;
+		setToCurrentMonotonicTimestamp_ns(start);
+
+		int bytes_op = is_read ? read_blocks_from_disk(iot->dbfilep, iot->buffer, start_block, iot->request_blocks) : write_blocks_to_disk(iot->dbfilep, iot->buffer, start_block, iot->request_blocks);
+
+		TIMESTAMP_ns end;
+		setToCurrentMonotonicTimestamp_ns(end);
+
+		if(bytes_op <= 0)
+			iot->io_errors++;
+		record_in_latency_histogram(&(iot->latencies), end - start);
+		iot->ios++;
+	}
+
+	return NULL;
+}
+
+static void run_random_io(dbfile* dbfilep, uint32_t block_count, int queue_depth, uint32_t request_blocks, int read_percentage, int seconds_per_run)
+{
+	// get_block_size() caches the block size in the dbfile on its first call, and it has already been called by main
+	SIZE_IN_BYTES block_size = get_block_size(dbfilep);
+
+	io_thread* iots = malloc(sizeof(io_thread) * queue_depth);
+
+	stop_io = 0;
+
+	struct timespec start_time, end_time;
+	clock_gettime(CLOCK_MONOTONIC, &start_time);
+
+	for(int i = 0; i < queue_depth; i++)
+	{
+		iots[i].dbfilep = dbfilep;
+		iots[i].block_count = block_count;
+		iots[i].request_blocks = request_blocks;
+		iots[i].read_percentage = read_percentage;
+		iots[i].alloc_memory = malloc(block_size * (request_blocks + 1));
+		iots[i].buffer = (void*)(((((uintptr_t)iots[i].alloc_memory) / block_size) + 1) * block_size);
+		memset(iots[i].buffer, 0, block_size * request_blocks);
+		iots[i].random_state = 0x9e3779b97f4a7c15ULL * (i + 1);
+		iots[i].ios = 0;
+		iots[i].io_errors = 0;
+		initialize_latency_histogram(&(iots[i].latencies));
+		pthread_create(&(iots[i].thread), NULL, io_thread_function, iots + i);
+	}
+
+	sleepForMilliseconds(((TIME_ms)seconds_per_run) * 1000);
+	stop_io = 1;
+
+	uint64_t ios = 0;
+	uint64_t io_errors = 0;
+	latency_histogram latencies;
+	initialize_latency_histogram(&latencies);
+	for(int i = 0; i < queue_depth; i++)
+	{
+		pthread_join(iots[i].thread, NULL);
+		ios += iots[i].ios;
+		io_errors += iots[i].io_errors;
+		merge_latency_histogram(&latencies, &(iots[i].latencies));
+		free(iots[i].alloc_memory);
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &end_time);
+	double seconds = diff_timespec(start_time, end_time);
+
+	printf("%d\t%u\t%d\t%.0lf\t%.2lf\t%lu\t%lu\t%lu\t%lu\n", queue_depth, request_blocks * block_size, read_percentage,
+		ios / seconds, (ios * request_blocks * block_size) / (seconds * 1024 * 1024),
+		get_percentile_of_latency_histogram(&latencies, 50.0) / 1000, get_percentile_of_latency_histogram(&latencies, 99.0) / 1000,
+		get_percentile_of_latency_histogram(&latencies, 99.9) / 1000, io_errors);
+	fflush(stdout);
+
+	free(iots);
+}
+
 int main(int argc, char **argv)
 {
 	printf("\n\ntest started\n\n");
@@ -14,11 +157,17 @@ int main(int argc, char **argv)
 	char filename[512] = "./test.db";
 	uint32_t block_count = 8;
 	uint32_t blocks_per_page = 8;
-	if(argc == 4)
+	int max_queue_depth = 0;
+	int seconds_per_run = 1;
+	if(argc >= 4 && argc <= 6)
 	{
 		strcpy(filename, argv[1]);
 		sscanf(argv[2], "%u", &block_count);
 		sscanf(argv[3], "%u", &blocks_per_page);
+		if(argc >= 5)
+			sscanf(argv[4], "%d", &max_queue_depth);
+		if(argc >= 6)
+			sscanf(argv[5], "%d", &seconds_per_run);
 	}
 	else
 	{
@@ -86,6 +235,22 @@ int main(int argc, char **argv)
 	clock_gettime(CLOCK_MONOTONIC, &end_time);
 	printf("Result 4 : read %ld bytes in %.10lf seconds time\n\n", bytes_op, diff_timespec(start_time, end_time));
 
+	if(max_queue_depth > 0)
+	{
+		printf("Test 5 : Random io sweep over queue depth, request size and read/write mix\n");
+		printf("queue_depth\trequest_bytes\tread_percentage\tiops\tMBps\tp50_us\tp99_us\tp999_us\terrors\n");
+		for(uint32_t s = 0; s < REQUEST_SIZES_COUNT; s++)
+		{
+			uint32_t request_blocks = (request_sizes_in_pages[s] == 0) ? 1 : (request_sizes_in_pages[s] * blocks_per_page);
+			if(request_blocks > block_count)
+				continue;
+			for(uint32_t m = 0; m < READ_PERCENTAGES_COUNT; m++)
+				for(int queue_depth = 1; queue_depth <= max_queue_depth; queue_depth *= 2)
+					run_random_io(dbfilep, block_count, queue_depth, request_blocks, read_percentages[m], seconds_per_run);
+		}
+		printf("\n");
+	}
+
 	close_dbfile(dbfilep);
 	free(alloc_memory);
 
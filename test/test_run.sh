@@ -8,11 +8,37 @@ then
 	sudo stat $FILENAME
 	sudo stat -f $FILENAME
 	sudo head -c `expr 512 \* 8 \* 20` $FILENAME
+elif [ $TEST_TYP = "bbqueue" ]
+then
+	./test_bbq.out
 elif [ $TEST_TYP = "io_speed" ]
 then
 	sudo time -v ./test_io.out $FILENAME 160 8
 	sudo time -v ./test_io.out $FILENAME 640 8
+	sudo ./test_io.out $FILENAME 262144 8 `expr \`nproc\` \* 4` 2
 	echo "1. Even on SSD sequential io is slower"
 	echo "2. With larger amount of data for io, the difference in sequential and random io increases"
 	echo "3. Always try to make fewer and bigger read/write calls for disk and execution effeciency"
+	echo "4. Pick the read_io_thread_count (and write_io_thread_count) of get_bufferpool near the queue depth, where the iops of Test 5 stop growing (or its p99 latency starts growing)"
+elif [ $TEST_TYP = "hit_path" ]
+then
+	sudo ./bench_hit_path.out $FILENAME `nproc` 2
+elif [ $TEST_TYP = "workload" ]
+then
+	sudo ./workload_driver.out $FILENAME distribution=uniform
+	sudo ./workload_driver.out $FILENAME distribution=zipfian
+	sudo ./workload_driver.out $FILENAME distribution=latest
+elif [ $TEST_TYP = "checksum" ]
+then
+	sudo ./bench_checksum.out $FILENAME 1024 2
+	echo "1. The page checksums (set_page_checksums) are worth keeping on, if the overhead percentages stay within a few percent"
+elif [ $TEST_TYP = "checksum_corruption" ]
+then
+	sudo ./test_checksum.out $FILENAME
+elif [ $TEST_TYP = "compression" ]
+then
+	sudo ./test_compression.out $FILENAME
+elif [ $TEST_TYP = "free_pages" ]
+then
+	sudo ./test_free_pages.out $FILENAME
 fi
\ No newline at end of file
@@ -0,0 +1,378 @@
+#include<stdio.h>
+#include<stdlib.h>
+#include<stdint.h>
+#include<string.h>
+
+#include<bufferpool.h>
+#include<page_access_trace.h>
+
+/*
+	replays a page access trace (recorded using start_page_access_trace), in one of the two modes
+
+	simulate : runs the page accesses of the trace, through a simulation of the replacement policy of the bufferpool, without any disk io
+			   this lets you evaluate the hit ratio of the trace, for different bufferpool sizes, in no time
+
+	drive :    drives a fresh bufferpool, with the page accesses of the trace, every access is an acquire immediately followed by a release of the page
+			   (with the same latch_mode and okay_to_evict as recorded), the prefetches of the trace are replayed as prefetches
+
+	usage :
+		./trace_replay.out simulate <trace_file> <pages_in_bufferpool>
+		./trace_replay.out drive <trace_file> <db_file> <pages_in_bufferpool> <read_io_thread_count> <write_io_thread_count>
+*/
+
+// ************ simulation of the replacement policy of the bufferpool (check least_recently_used.c)
+
+// the lists of frames, the victim is selected from the head of the first non empty list, in this order
+typedef enum sim_list_id sim_list_id;
+enum sim_list_id
+{
+	FREE_LIST = 0,
+	EVICTABLE_LIST,
+	CLEAN_LIST,
+	DIRTY_LIST,
+	SIM_LISTS_COUNT,
+	NOT_IN_ANY_LIST
+};
+
+typedef struct sim_frame sim_frame;
+struct sim_frame
+{
+	PAGE_ID page_id;
+	int is_valid;
+	int is_dirty;
+	uint32_t pinned_by_count;
+
+	sim_list_id list_id;
+	int64_t prev;
+	int64_t next;
+
+	// next frame in the same bucket of the page_id hash table
+	int64_t next_in_bucket;
+};
+
+typedef struct sim_list sim_list;
+struct sim_list
+{
+	int64_t head;
+	int64_t tail;
+};
+
+typedef struct simulator simulator;
+struct simulator
+{
+	PAGE_COUNT frames_count;
+	sim_frame* frames;
+
+	sim_list lists[SIM_LISTS_COUNT];
+
+	uint64_t buckets_count;
+	int64_t* buckets;
+
+	uint64_t hits;
+	uint64_t misses;
+	uint64_t evictions;
+	uint64_t dirty_evictions;
+
+	// misses, when all the frames were pinned (the real bufferpool would have waited here)
+	uint64_t stalls;
+};
+
+static void remove_from_sim_list(simulator* sim, int64_t f)
+{
+	sim_frame* frame = sim->frames + f;
+	if(frame->list_id == NOT_IN_ANY_LIST)
+		return;
+	sim_list* list = sim->lists + frame->list_id;
+	if(frame->prev != -1)
+		sim->frames[frame->prev].next = frame->next;
+	else
+		list->head = frame->next;
+	if(frame->next != -1)
+		sim->frames[frame->next].prev = frame->prev;
+	else
+		list->tail = frame->prev;
+	frame->prev = frame->next = -1;
+	frame->list_id = NOT_IN_ANY_LIST;
+}
+
+static void insert_in_sim_list(simulator* sim, int64_t f, sim_list_id list_id, int at_head)
+{
+	sim_frame* frame = sim->frames + f;
+	sim_list* list = sim->lists + list_id;
+	frame->list_id = list_id;
+	if(list->head == -1)
+	{
+		frame->prev = frame->next = -1;
+		list->head = list->tail = f;
+	}
+	else if(at_head)
+	{
+		frame->prev = -1;
+		frame->next = list->head;
+		sim->frames[list->head].prev = f;
+		list->head = f;
+	}
+	else
+	{
+		frame->next = -1;
+		frame->prev = list->tail;
+		sim->frames[list->tail].next = f;
+		list->tail = f;
+	}
+}
+
+static uint64_t get_bucket(simulator* sim, PAGE_ID page_id)
+{
+	return (page_id * 2654435761ULL) % sim->buckets_count;
+}
+
+static int64_t find_sim_frame(simulator* sim, PAGE_ID page_id)
+{
+	for(int64_t f = sim->buckets[get_bucket(sim, page_id)]; f != -1; f = sim->frames[f].next_in_bucket)
+		if(sim->frames[f].page_id == page_id && sim->frames[f].is_valid)
+			return f;
+	return -1;
+}
+
+static void remove_sim_frame_from_buckets(simulator* sim, int64_t f)
+{
+	int64_t* link = sim->buckets + get_bucket(sim, sim->frames[f].page_id);
+	while(*link != -1)
+	{
+		if(*link == f)
+		{
+			*link = sim->frames[f].next_in_bucket;
+			break;
+		}
+		link = &(sim->frames[*link].next_in_bucket);
+	}
+	sim->frames[f].next_in_bucket = -1;
+}
+
+static void initialize_simulator(simulator* sim, PAGE_COUNT frames_count)
+{
+	memset(sim, 0, sizeof(simulator));
+	sim->frames_count = frames_count;
+	sim->frames = malloc(sizeof(sim_frame) * frames_count);
+	for(int l = 0; l < SIM_LISTS_COUNT; l++)
+		sim->lists[l] = (sim_list){.head = -1, .tail = -1};
+	sim->buckets_count = 2 * frames_count + 1;
+	sim->buckets = malloc(sizeof(int64_t) * sim->buckets_count);
+	for(uint64_t b = 0; b < sim->buckets_count; b++)
+		sim->buckets[b] = -1;
+	for(PAGE_COUNT f = 0; f < frames_count; f++)
+	{
+		sim->frames[f] = (sim_frame){.is_valid = 0, .list_id = NOT_IN_ANY_LIST, .prev = -1, .next = -1, .next_in_bucket = -1};
+		insert_in_sim_list(sim, f, FREE_LIST, 0);
+	}
+}
+
+// brings the page into a victim frame, and returns the frame, it returns -1, if all the frames are pinned
+static int64_t load_sim_page(simulator* sim, PAGE_ID page_id)
+{
+	for(int l = 0; l < SIM_LISTS_COUNT; l++)
+	{
+		int64_t f = sim->lists[l].head;
+		if(f == -1)
+			continue;
+
+		remove_from_sim_list(sim, f);
+		sim_frame* frame = sim->frames + f;
+		if(frame->is_valid)
+		{
+			sim->evictions++;
+			if(frame->is_dirty)
+				sim->dirty_evictions++;
+			remove_sim_frame_from_buckets(sim, f);
+		}
+
+		frame->page_id = page_id;
+		frame->is_valid = 1;
+		frame->is_dirty = 0;
+		frame->pinned_by_count = 0;
+		frame->next_in_bucket = sim->buckets[get_bucket(sim, page_id)];
+		sim->buckets[get_bucket(sim, page_id)] = f;
+		return f;
+	}
+	return -1;
+}
+
+static void simulate_event(simulator* sim, const page_access_trace_event* event)
+{
+	int64_t f = find_sim_frame(sim, event->page_id);
+	switch(event->event_type)
+	{
+		case ACQUIRE_EVENT :
+		{
+			if(f != -1)
+				sim->hits++;
+			else
+			{
+				sim->misses++;
+				f = load_sim_page(sim, event->page_id);
+				if(f == -1)
+				{
+					sim->stalls++;
+					return;
+				}
+			}
+			remove_from_sim_list(sim, f);
+			sim->frames[f].pinned_by_count++;
+			break;
+		}
+		case RELEASE_EVENT :
+		{
+			// the acquire of this page may have stalled in the simulation
+			if(f == -1 || sim->frames[f].pinned_by_count == 0)
+				return;
+			sim_frame* frame = sim->frames + f;
+			frame->pinned_by_count--;
+			if(event->latch_mode == WRITER_LATCH)
+				frame->is_dirty = 1;
+			if(frame->pinned_by_count == 0)
+			{
+				if(event->okay_to_evict)
+					insert_in_sim_list(sim, f, EVICTABLE_LIST, 1);
+				else
+					insert_in_sim_list(sim, f, frame->is_dirty ? DIRTY_LIST : CLEAN_LIST, 0);
+			}
+			break;
+		}
+		case PREFETCH_EVENT :
+		case READ_AHEAD_EVENT :
+		{
+			// a prefetched page is not yet used, so it is the first to be evicted from its list
+			if(f == -1)
+			{
+				f = load_sim_page(sim, event->page_id);
+				if(f != -1)
+					insert_in_sim_list(sim, f, CLEAN_LIST, 1);
+			}
+			break;
+		}
+		default :
+		{
+			// the evictions of the trace, are the result of the policy, they are not replayed
+			break;
+		}
+	}
+}
+
+// ************ reading the trace file
+
+static FILE* open_trace_file(char* trace_file_name, page_access_trace_file_header* header)
+{
+	FILE* trace_file = fopen(trace_file_name, "rb");
+	if(trace_file == NULL)
+	{
+		printf("trace file %s could not be opened\n", trace_file_name);
+		return NULL;
+	}
+	if(fread(header, sizeof(page_access_trace_file_header), 1, trace_file) != 1 || header->magic != PAGE_ACCESS_TRACE_MAGIC
+		|| header->version != PAGE_ACCESS_TRACE_VERSION || header->event_size != sizeof(page_access_trace_event))
+	{
+		printf("%s is not a page access trace file, of this version\n", trace_file_name);
+		fclose(trace_file);
+		return NULL;
+	}
+	printf("trace of bufferpool with %u pages of %u bytes, events written = %lu, events dropped = %lu\n",
+		header->pages_in_bufferpool, header->page_size, header->events_written, header->events_dropped);
+	return trace_file;
+}
+
+static int simulate(char* trace_file_name, PAGE_COUNT pages_in_bufferpool)
+{
+	page_access_trace_file_header header;
+	FILE* trace_file = open_trace_file(trace_file_name, &header);
+	if(trace_file == NULL)
+		return -1;
+
+	simulator sim;
+	initialize_simulator(&sim, pages_in_bufferpool);
+
+	// the misses recorded in the trace, to be compared with the simulation
+	uint64_t recorded_acquires = 0;
+	uint64_t recorded_misses = 0;
+
+	page_access_trace_event event;
+	while(fread(&event, sizeof(page_access_trace_event), 1, trace_file) == 1)
+	{
+		if(event.event_type == ACQUIRE_EVENT)
+		{
+			recorded_acquires++;
+			recorded_misses += event.is_miss;
+		}
+		simulate_event(&sim, &event);
+	}
+	fclose(trace_file);
+
+	printf("{\"mode\" : \"simulate\", \"pages_in_bufferpool\" : %u, \"acquires\" : %lu, \"hits\" : %lu, \"misses\" : %lu, \"hit_ratio\" : %.4f, \"evictions\" : %lu, \"dirty_evictions\" : %lu, \"stalls\" : %lu, \"recorded_misses\" : %lu, \"recorded_hit_ratio\" : %.4f}\n",
+		pages_in_bufferpool, sim.hits + sim.misses, sim.hits, sim.misses, (sim.hits + sim.misses) ? ((double)sim.hits) / (sim.hits + sim.misses) : 0.0,
+		sim.evictions, sim.dirty_evictions, sim.stalls,
+		recorded_misses, recorded_acquires ? ((double)(recorded_acquires - recorded_misses)) / recorded_acquires : 0.0);
+
+	free(sim.frames);
+	free(sim.buckets);
+	return 0;
+}
+
+static int drive(char* trace_file_name, char* db_file_name, PAGE_COUNT pages_in_bufferpool, uint8_t read_io_thread_count, uint8_t write_io_thread_count)
+{
+	page_access_trace_file_header header;
+	FILE* trace_file = open_trace_file(trace_file_name, &header);
+	if(trace_file == NULL)
+		return -1;
+
+	// prefetched pages that are never acquired, must be returned to the bufferpool quickly, else they would hold up the frames of small bufferpools
+	bufferpool* buffp = get_bufferpool(db_file_name, pages_in_bufferpool, header.page_size, read_io_thread_count, write_io_thread_count, 1000, 20);
+	if(buffp == NULL)
+	{
+		fclose(trace_file);
+		return -1;
+	}
+
+	bbqueue* bbq = get_bbqueue(1);
+
+	// every access is replayed at its release event, since it tells us the latch_mode and the okay_to_evict of the access
+	page_access_trace_event event;
+	while(fread(&event, sizeof(page_access_trace_event), 1, trace_file) == 1)
+	{
+		if(event.event_type == RELEASE_EVENT)
+		{
+			page_handle pg_handle = (event.latch_mode == WRITER_LATCH) ? acquire_page_with_writer_lock(buffp, event.page_id) : acquire_page_with_reader_lock(buffp, event.page_id);
+			release_page_lock(buffp, &pg_handle, event.okay_to_evict);
+		}
+		else if(event.event_type == PREFETCH_EVENT)
+		{
+			request_page_prefetch(buffp, event.page_id, 1, bbq);
+			pop_bbqueue(bbq);
+		}
+	}
+	fclose(trace_file);
+
+	bufferpool_stats stats;
+	get_bufferpool_stats(buffp, &stats);
+	latency_histogram hist;
+	get_bufferpool_latency_histogram(buffp, ACQUIRE_PAGE_LATENCY, &hist);
+
+	printf("{\"mode\" : \"drive\", \"pages_in_bufferpool\" : %u, \"hits\" : %lu, \"misses\" : %lu, \"evictions\" : %lu, \"writebacks_on_miss_path\" : %lu, \"acquire_p50_ns\" : %lu, \"acquire_p99_ns\" : %lu, \"acquire_p999_ns\" : %lu}\n",
+		pages_in_bufferpool, stats.page_hits, stats.page_misses, stats.evictions, stats.writebacks_on_miss_path,
+		get_percentile_of_latency_histogram(&hist, 50.0), get_percentile_of_latency_histogram(&hist, 99.0), get_percentile_of_latency_histogram(&hist, 99.9));
+
+	delete_bufferpool(buffp);
+	delete_bbqueue(bbq);
+	return 0;
+}
+
+int main(int argc, char** argv)
+{
+	if(argc == 4 && strcmp(argv[1], "simulate") == 0)
+		return simulate(argv[2], atoi(argv[3]));
+	else if(argc == 7 && strcmp(argv[1], "drive") == 0)
+		return drive(argv[2], argv[3], atoi(argv[4]), atoi(argv[5]), atoi(argv[6]));
+
+	printf("usage :\n");
+	printf("\t%s simulate <trace_file> <pages_in_bufferpool>\n", argv[0]);
+	printf("\t%s drive <trace_file> <db_file> <pages_in_bufferpool> <read_io_thread_count> <write_io_thread_count>\n", argv[0]);
+	return -1;
+}
\ No newline at end of file
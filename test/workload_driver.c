@@ -0,0 +1,508 @@
+#include<stdio.h>
+#include<stdlib.h>
+#include<stdint.h>
+#include<string.h>
+#include<math.h>
+
+#include<pthread.h>
+#include<sys/stat.h>
+
+#include<bufferpool.h>
+
+/*
+	a YCSB like workload driver for the bufferpool, over a heap file larger than the bufferpool
+
+	it runs a configurable mix of
+		point reads  : acquire a page with reader lock
+		point writes : acquire a page with writer lock and modify it
+		range scans  : prefetch scan_length consecutive pages (request_page_prefetch + bbqueue), and read them in the order they arrive
+		appends      : write a new page at the end of the heap file
+
+	the pages are picked by one of the distributions
+		uniform      : every page of the heap file is equally likely
+		zipfian      : a few pages are very hot (the zipfian constant is theta), the hot pages are scattered all over the heap file
+		latest       : the recently appended pages are the hottest (zipfian over the recency of the pages)
+
+	it reports the throughput, the hit ratio of the bufferpool and the latency percentiles of each of the operations, as a JSON object
+
+	usage :
+		./workload_driver.out <db_file> [key=value ...]
+
+	keys (and their defaults) :
+		pages_in_bufferpool=4096 heap_pages=65536 page_size=4096 read_io_threads=4 write_io_threads=2
+		threads=8 seconds=10 distribution=zipfian theta=0.99
+		read=70 write=20 scan=5 append=5 (percentages of the operations)
+		scan_length=64
+		elevator_band=0 (the priority_band of set_elevator_dispatch)
+		dirty_ratio=0 (the dirty_percentage of set_dirty_pages_ratio_limit)
+		shadow_copy_writeback=0 (1 to enable set_shadow_copy_writeback)
+		warm_restart_file= (if given, the bufferpool is warmed up from this file before measuring, and the resident pages are dumped to it at the end)
+		compressed_cache_mb=0 (the bytes_budget of set_compressed_page_cache_budget, in MB)
+		extent_map_file= (if given, the pages are stored compressed on disk, with this file as the extent map of set_page_compression)
+		l2_file= l2_pages=0 (if both are given, a victim cache of l2_pages pages is kept in the l2_file, using set_l2_page_cache)
+		hole_detection=0 (1 to enable set_hole_detection)
+		numa_interleave=0 (1 to interleave the frames across the NUMA nodes, using set_numa_interleave)
+		reserve_appends=0 (1 to reserve the disk space for the appended pages, using reserve_pages_on_disk, before they are written)
+*/
+
+typedef enum distribution distribution;
+enum distribution
+{
+	UNIFORM,
+	ZIPFIAN,
+	LATEST
+};
+
+typedef enum operation operation;
+enum operation
+{
+	POINT_READ,
+	POINT_WRITE,
+	RANGE_SCAN,
+	APPEND,
+	OPERATIONS_COUNT
+};
+
+char* operation_names[OPERATIONS_COUNT] = {"read", "write", "scan", "append"};
+
+// the workload configuration
+PAGE_COUNT pages_in_bufferpool = 4096;
+PAGE_COUNT heap_pages = 65536;
+SIZE_IN_BYTES page_size = 4096;
+uint8_t read_io_threads = 4;
+uint8_t write_io_threads = 2;
+int threads_count = 8;
+int seconds = 10;
+distribution dist = ZIPFIAN;
+double theta = 0.99;
+int operation_percentages[OPERATIONS_COUNT] = {70, 20, 5, 5};
+PAGE_COUNT scan_length = 64;
+uint8_t elevator_band = 0;
+uint8_t dirty_ratio = 0;
+int shadow_copy_writeback = 0;
+char warm_restart_file[64] = "";
+char extent_map_file[64] = "";
+uint64_t compressed_cache_mb = 0;
+char l2_file[64] = "";
+PAGE_COUNT l2_pages = 0;
+int hole_detection = 0;
+int reserve_appends = 0;
+int numa_interleave = 0;
+
+bufferpool* bpm = NULL;
+
+// the number of pages in the heap file, it grows with the appends
+PAGE_COUNT pages_in_heap = 0;
+
+volatile int stop_measuring = 0;
+
+// ************ zipfian generator (Jim Gray et al., "Quickly Generating Billion-Record Synthetic Databases", as used in YCSB)
+
+typedef struct zipfian zipfian;
+struct zipfian
+{
+	uint64_t items;
+	double theta;
+	double zetan;
+	double alpha;
+	double eta;
+};
+
+static double zeta(uint64_t n, double theta)
+{
+	double sum = 0;
+	for(uint64_t i = 1; i <= n; i++)
+		sum += 1.0 / pow((double)i, theta);
+	return sum;
+}
+
+static void initialize_zipfian(zipfian* z, uint64_t items, double theta)
+{
+	z->items = items;
+	z->theta = theta;
+	z->zetan = zeta(items, theta);
+	z->alpha = 1.0 / (1.0 - theta);
+	z->eta = (1.0 - pow(2.0 / items, 1.0 - theta)) / (1.0 - zeta(2, theta) / z->zetan);
+}
+
+// returns a rank in [0, items), the rank 0 is the most likely
+static uint64_t next_zipfian(zipfian* z, double u)
+{
+	double uz = u * z->zetan;
+	if(uz < 1.0)
+		return 0;
+	if(uz < 1.0 + pow(0.5, z->theta))
+		return 1;
+	uint64_t rank = (uint64_t)(z->items * pow(z->eta * u - z->eta + 1.0, z->alpha));
+	return (rank >= z->items) ? (z->items - 1) : rank;
+}
+
+zipfian zipf;
+
+// ************ per thread state
+
+typedef struct worker worker;
+struct worker
+{
+	pthread_t thread;
+
+	uint64_t random_state;
+
+	bbqueue* scan_bbq;
+
+	uint64_t ops[OPERATIONS_COUNT];
+
+	latency_histogram latencies[OPERATIONS_COUNT];
+};
+
+static uint64_t next_random(uint64_t* state)
+{
+	// xorshift64
+	uint64_t x = *state;
+	x ^= x << 13;
+	x ^= x >> 7;
+	x ^= x << 17;
+	return (*state = x);
+}
+
+// returns a uniformly random double in [0, 1)
+static double next_random_double(uint64_t* state)
+{
+	return (next_random(state) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+// scatters the zipfian ranks all over the heap file, so that the hot pages are not adjacent (like the scrambled zipfian of YCSB)
+static PAGE_ID scramble(uint64_t rank)
+{
+	uint64_t hash = 14695981039346656037ULL;
+	for(int i = 0; i < 8; i++)
+	{
+		hash ^= (rank >> (i * 8)) & 0xff;
+		hash *= 1099511628211ULL;
+	}
+	return hash % heap_pages;
+}
+
+static PAGE_ID next_page_id(worker* w)
+{
+	PAGE_COUNT pages = __atomic_load_n(&pages_in_heap, __ATOMIC_RELAXED);
+	switch(dist)
+	{
+		case ZIPFIAN :
+			return scramble(next_zipfian(&zipf, next_random_double(&(w->random_state))));
+		case LATEST :
+		{
+			// the zipfian is built over heap_pages, so the rank is always lesser than the pages in the heap
+			uint64_t rank = next_zipfian(&zipf, next_random_double(&(w->random_state)));
+			return pages - 1 - rank;
+		}
+		case UNIFORM :
+		default :
+			return next_random(&(w->random_state)) % pages;
+	}
+}
+
+static operation next_operation(worker* w)
+{
+	int r = next_random(&(w->random_state)) % 100;
+	for(operation op = 0; op < OPERATIONS_COUNT; op++)
+	{
+		if(r < operation_percentages[op])
+			return op;
+		r -= operation_percentages[op];
+	}
+	return POINT_READ;
+}
+
+static void write_page_contents(void* page_memory, PAGE_ID page_id)
+{
+	((uint64_t*)page_memory)[0] = page_id;
+	((uint64_t*)page_memory)[1]++;
+}
+
+static void* worker_function(void* param)
+{
+	worker* w = param;
+
+	while(!stop_measuring)
+	{
+		operation op = next_operation(w);
+
+		TIMESTAMP_ns start;
+		setToCurrentMonotonicTimestamp_ns(start);
+
+		switch(op)
+		{
+			case POINT_READ :
+			{
+				page_handle pg_handle = acquire_page_with_reader_lock(bpm, next_page_id(w));
+				release_page_lock(bpm, &pg_handle, 0);
+				break;
+			}
+			case POINT_WRITE :
+			{
+				page_handle pg_handle = acquire_page_with_writer_lock(bpm, next_page_id(w));
+				write_page_contents(pg_handle.page_memory, pg_handle.page_id);
+				release_page_lock(bpm, &pg_handle, 0);
+				break;
+			}
+			case RANGE_SCAN :
+			{
+				PAGE_ID start_page_id = next_page_id(w);
+				PAGE_COUNT pages = __atomic_load_n(&pages_in_heap, __ATOMIC_RELAXED);
+				PAGE_COUNT length = (start_page_id + scan_length <= pages) ? scan_length : (pages - start_page_id);
+
+				// the pages are read in the order in which they arrive in memory, and they are okay to be evicted after the scan
+				request_page_prefetch(bpm, start_page_id, length, w->scan_bbq);
+				for(PAGE_COUNT consumed = 0; consumed < length;)
+				{
+					PAGE_ID ready_page_ids[64];
+					uint32_t ready_count = pop_bbqueue_batch(w->scan_bbq, ready_page_ids, 64);
+					for(uint32_t i = 0; i < ready_count; i++)
+					{
+						page_handle pg_handle = acquire_page_with_reader_lock(bpm, ready_page_ids[i]);
+						release_page_lock(bpm, &pg_handle, 1);
+					}
+					consumed += ready_count;
+				}
+				break;
+			}
+			case APPEND :
+			default :
+			{
+				PAGE_ID page_id = __atomic_fetch_add(&pages_in_heap, 1, __ATOMIC_RELAXED);
+				if(reserve_appends)
+					reserve_pages_on_disk(bpm, page_id, 1);
+				page_handle pg_handle = acquire_page_with_writer_lock(bpm, page_id);
+				write_page_contents(pg_handle.page_memory, pg_handle.page_id);
+				release_page_lock(bpm, &pg_handle, 0);
+				break;
+			}
+		}
+
+		TIMESTAMP_ns end;
+		setToCurrentMonotonicTimestamp_ns(end);
+
+		record_in_latency_histogram(&(w->latencies[op]), end - start);
+		w->ops[op]++;
+	}
+
+	return NULL;
+}
+
+static int parse_argument(char* arg)
+{
+	char key[64];
+	char value[64];
+	if(sscanf(arg, "%63[^=]=%63s", key, value) != 2)
+		return 0;
+
+	if(strcmp(key, "pages_in_bufferpool") == 0)
+		pages_in_bufferpool = atoi(value);
+	else if(strcmp(key, "heap_pages") == 0)
+		heap_pages = atoi(value);
+	else if(strcmp(key, "page_size") == 0)
+		page_size = atoi(value);
+	else if(strcmp(key, "read_io_threads") == 0)
+		read_io_threads = atoi(value);
+	else if(strcmp(key, "write_io_threads") == 0)
+		write_io_threads = atoi(value);
+	else if(strcmp(key, "threads") == 0)
+		threads_count = atoi(value);
+	else if(strcmp(key, "seconds") == 0)
+		seconds = atoi(value);
+	else if(strcmp(key, "theta") == 0)
+		theta = atof(value);
+	else if(strcmp(key, "scan_length") == 0)
+		scan_length = atoi(value);
+	else if(strcmp(key, "elevator_band") == 0)
+		elevator_band = atoi(value);
+	else if(strcmp(key, "dirty_ratio") == 0)
+		dirty_ratio = atoi(value);
+	else if(strcmp(key, "shadow_copy_writeback") == 0)
+		shadow_copy_writeback = atoi(value);
+	else if(strcmp(key, "warm_restart_file") == 0)
+		strcpy(warm_restart_file, value);
+	else if(strcmp(key, "compressed_cache_mb") == 0)
+		compressed_cache_mb = strtoull(value, NULL, 10);
+	else if(strcmp(key, "extent_map_file") == 0)
+		strcpy(extent_map_file, value);
+	else if(strcmp(key, "l2_file") == 0)
+		strcpy(l2_file, value);
+	else if(strcmp(key, "l2_pages") == 0)
+		l2_pages = atoi(value);
+	else if(strcmp(key, "hole_detection") == 0)
+		hole_detection = atoi(value);
+	else if(strcmp(key, "reserve_appends") == 0)
+		reserve_appends = atoi(value);
+	else if(strcmp(key, "numa_interleave") == 0)
+		numa_interleave = atoi(value);
+	else if(strcmp(key, "read") == 0)
+		operation_percentages[POINT_READ] = atoi(value);
+	else if(strcmp(key, "write") == 0)
+		operation_percentages[POINT_WRITE] = atoi(value);
+	else if(strcmp(key, "scan") == 0)
+		operation_percentages[RANGE_SCAN] = atoi(value);
+	else if(strcmp(key, "append") == 0)
+		operation_percentages[APPEND] = atoi(value);
+	else if(strcmp(key, "distribution") == 0)
+	{
+		if(strcmp(value, "uniform") == 0)
+			dist = UNIFORM;
+		else if(strcmp(value, "zipfian") == 0)
+			dist = ZIPFIAN;
+		else if(strcmp(value, "latest") == 0)
+			dist = LATEST;
+		else
+			return 0;
+	}
+	else
+		return 0;
+
+	return 1;
+}
+
+int main(int argc, char** argv)
+{
+	if(argc < 2)
+	{
+		printf("usage : %s <db_file> [key=value ...], check the comment at the top of workload_driver.c for the keys\n", argv[0]);
+		return -1;
+	}
+
+	for(int i = 2; i < argc; i++)
+	{
+		if(!parse_argument(argv[i]))
+		{
+			printf("invalid argument %s\n", argv[i]);
+			return -1;
+		}
+	}
+
+	if(operation_percentages[POINT_READ] + operation_percentages[POINT_WRITE] + operation_percentages[RANGE_SCAN] + operation_percentages[APPEND] != 100
+		|| heap_pages == 0 || threads_count <= 0 || scan_length == 0)
+	{
+		printf("the operation percentages must add upto 100, and heap_pages, threads and scan_length must be positive\n");
+		return -1;
+	}
+
+	// the heap file must be written upto heap_pages before measuring, else the reads beyond the end of the file would not do any disk io
+	struct stat file_stat;
+	int is_load_required = (stat(argv[1], &file_stat) != 0) || (file_stat.st_size < ((off_t)heap_pages) * page_size);
+
+	bpm = get_bufferpool(argv[1], pages_in_bufferpool, page_size, read_io_threads, write_io_threads, 1000, 100);
+	if(bpm == NULL)
+		return -1;
+
+	set_elevator_dispatch(bpm, elevator_band);
+	set_dirty_pages_ratio_limit(bpm, dirty_ratio);
+	set_shadow_copy_writeback(bpm, shadow_copy_writeback);
+	if(numa_interleave && !set_numa_interleave(bpm))
+		fprintf(stderr, "the frames are not interleaved, there is only one NUMA node\n");
+	set_compressed_page_cache_budget(bpm, compressed_cache_mb * 1024 * 1024);
+	if(extent_map_file[0] != '\0' && !set_page_compression(bpm, extent_map_file))
+	{
+		printf("could not open the extent map file %s\n", extent_map_file);
+		delete_bufferpool(bpm);
+		return -1;
+	}
+	if(l2_file[0] != '\0' && l2_pages > 0 && !set_l2_page_cache(bpm, l2_file, l2_pages))
+	{
+		printf("could not open the l2 file %s\n", l2_file);
+		delete_bufferpool(bpm);
+		return -1;
+	}
+	if(hole_detection && !set_hole_detection(bpm))
+		printf("the file system of %s can not report holes, hole detection is not enabled\n", argv[1]);
+
+	if(is_load_required)
+	{
+		fprintf(stderr, "loading %u pages to the heap file\n", heap_pages);
+		for(PAGE_ID page_id = 0; page_id < heap_pages; page_id++)
+		{
+			page_handle pg_handle = acquire_page_with_writer_lock(bpm, page_id);
+			write_page_contents(pg_handle.page_memory, page_id);
+			release_page_lock(bpm, &pg_handle, 1);
+		}
+	}
+
+	if(warm_restart_file[0] != '\0')
+	{
+		fprintf(stderr, "warmed up the bufferpool with %u pages\n", warm_up_bufferpool(bpm, warm_restart_file));
+		dump_resident_pages_on_delete(bpm, warm_restart_file);
+	}
+
+	pages_in_heap = heap_pages;
+	initialize_zipfian(&zipf, heap_pages, theta);
+
+	bufferpool_stats stats_before;
+	get_bufferpool_stats(bpm, &stats_before);
+
+	worker* workers = malloc(sizeof(worker) * threads_count);
+	for(int i = 0; i < threads_count; i++)
+	{
+		workers[i].random_state = 0x9e3779b97f4a7c15ULL * (i + 1);
+		workers[i].scan_bbq = get_bbqueue(scan_length);
+		for(operation op = 0; op < OPERATIONS_COUNT; op++)
+		{
+			workers[i].ops[op] = 0;
+			initialize_latency_histogram(&(workers[i].latencies[op]));
+		}
+	}
+
+	TIMESTAMP_ns start;
+	setToCurrentMonotonicTimestamp_ns(start);
+
+	for(int i = 0; i < threads_count; i++)
+		pthread_create(&(workers[i].thread), NULL, worker_function, workers + i);
+
+	sleepForMilliseconds(((TIME_ms)seconds) * 1000);
+	stop_measuring = 1;
+
+	uint64_t ops[OPERATIONS_COUNT] = {};
+	latency_histogram latencies[OPERATIONS_COUNT];
+	for(operation op = 0; op < OPERATIONS_COUNT; op++)
+		initialize_latency_histogram(latencies + op);
+
+	for(int i = 0; i < threads_count; i++)
+	{
+		pthread_join(workers[i].thread, NULL);
+		for(operation op = 0; op < OPERATIONS_COUNT; op++)
+		{
+			ops[op] += workers[i].ops[op];
+			merge_latency_histogram(latencies + op, &(workers[i].latencies[op]));
+		}
+		delete_bbqueue(workers[i].scan_bbq);
+	}
+
+	TIMESTAMP_ns end;
+	setToCurrentMonotonicTimestamp_ns(end);
+	double elapsed_seconds = ((double)(end - start)) / 1000000000.0;
+
+	bufferpool_stats stats_after;
+	get_bufferpool_stats(bpm, &stats_after);
+	uint64_t hits = stats_after.page_hits - stats_before.page_hits;
+	uint64_t misses = stats_after.page_misses - stats_before.page_misses;
+
+	char* distribution_names[] = {"uniform", "zipfian", "latest"};
+	uint64_t total_ops = ops[POINT_READ] + ops[POINT_WRITE] + ops[RANGE_SCAN] + ops[APPEND];
+
+	printf("{\"distribution\" : \"%s\", \"theta\" : %.2f, \"pages_in_bufferpool\" : %u, \"heap_pages\" : %u, \"threads\" : %d, \"elevator_band\" : %u, \"dirty_ratio\" : %u, \"seconds\" : %.2f, ",
+		distribution_names[dist], theta, pages_in_bufferpool, heap_pages, threads_count, elevator_band, dirty_ratio, elapsed_seconds);
+	printf("\"ops\" : %lu, \"ops_per_second\" : %.0f, \"page_hits\" : %lu, \"page_misses\" : %lu, \"hit_ratio\" : %.4f, \"evictions\" : %lu, \"writebacks_on_miss_path\" : %lu, \"writers_throttled\" : %lu, \"compressed_cache_hits\" : %lu, \"l2_cache_hits\" : %lu",
+		total_ops, total_ops / elapsed_seconds, hits, misses, (hits + misses) ? ((double)hits) / (hits + misses) : 0.0,
+		stats_after.evictions - stats_before.evictions, stats_after.writebacks_on_miss_path - stats_before.writebacks_on_miss_path,
+		stats_after.writers_throttled - stats_before.writers_throttled, stats_after.compressed_cache_hits - stats_before.compressed_cache_hits,
+		stats_after.l2_cache_hits - stats_before.l2_cache_hits);
+	for(operation op = 0; op < OPERATIONS_COUNT; op++)
+	{
+		printf(", \"%s\" : {\"ops\" : %lu, \"p50_ns\" : %lu, \"p99_ns\" : %lu, \"p999_ns\" : %lu}", operation_names[op], ops[op],
+			get_percentile_of_latency_histogram(latencies + op, 50.0), get_percentile_of_latency_histogram(latencies + op, 99.0), get_percentile_of_latency_histogram(latencies + op, 99.9));
+	}
+	printf("}\n");
+
+	free(workers);
+	delete_bufferpool(bpm);
+
+	return 0;
+}
\ No newline at end of file